@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Leveled async logger for the request path. Producers enqueue into a
+// lock-free bounded MPMC ring (Vyukov-style sequence numbers) and a
+// background thread drains it to stderr, so a log line costs an atomic
+// CAS and a string move instead of an unbuffered write() syscall. When
+// the ring is full lines are dropped and counted — losing debug logs
+// beats blocking the dispatch pool. Startup/shutdown logging should keep
+// using std::cout directly (synchronous by design).
+//
+// Levels below CPPWORKER_MIN_LOG_LEVEL compile out entirely; at runtime
+// the threshold can be raised back up with LOG_LEVEL=debug|info|warn|error
+// (default info, which silences the per-request lines).
+
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3
+};
+
+#ifndef CPPWORKER_MIN_LOG_LEVEL
+#define CPPWORKER_MIN_LOG_LEVEL 0
+#endif
+
+class AsyncLogger {
+public:
+    static AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    void start() {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        drainer_ = std::thread([this] { drainLoop(); });
+    }
+
+    void stop() {
+        bool expected = true;
+        if (!running_.compare_exchange_strong(expected, false)) {
+            return;
+        }
+        if (drainer_.joinable()) {
+            drainer_.join();  // drainLoop flushes the ring before returning
+        }
+    }
+
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= runtime_level_;
+    }
+
+    void log(LogLevel level, std::string line) {
+        if (!enabled(level)) {
+            return;
+        }
+        if (!running_.load(std::memory_order_relaxed)) {
+            // Logger not started (early startup, tests): fall back to sync.
+            std::fputs(line.c_str(), stderr);
+            std::fputc('\n', stderr);
+            return;
+        }
+        if (!enqueue(std::move(line))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kCapacity = 4096;  // power of two
+
+    struct Slot {
+        std::atomic<size_t> seq;
+        std::string text;
+    };
+
+    AsyncLogger() : ring_(kCapacity) {
+        for (size_t i = 0; i < kCapacity; i++) {
+            ring_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        const char* env = std::getenv("LOG_LEVEL");
+        if (env) {
+            if (std::strcmp(env, "debug") == 0) runtime_level_ = 0;
+            else if (std::strcmp(env, "info") == 0) runtime_level_ = 1;
+            else if (std::strcmp(env, "warn") == 0) runtime_level_ = 2;
+            else if (std::strcmp(env, "error") == 0) runtime_level_ = 3;
+        }
+    }
+
+    ~AsyncLogger() {
+        stop();
+    }
+
+    bool enqueue(std::string&& line) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = ring_[pos & (kCapacity - 1)];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    slot.text = std::move(line);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // ring full
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Single consumer.
+    bool dequeue(std::string& line) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& slot = ring_[pos & (kCapacity - 1)];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;  // empty
+        }
+        line = std::move(slot.text);
+        slot.seq.store(pos + kCapacity, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void drainLoop() {
+        std::string line;
+        while (running_.load(std::memory_order_relaxed)) {
+            bool drained = false;
+            while (dequeue(line)) {
+                std::fputs(line.c_str(), stderr);
+                std::fputc('\n', stderr);
+                drained = true;
+            }
+            if (drained) {
+                std::fflush(stderr);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        // Final flush after stop().
+        while (dequeue(line)) {
+            std::fputs(line.c_str(), stderr);
+            std::fputc('\n', stderr);
+        }
+        std::fflush(stderr);
+    }
+
+    std::vector<Slot> ring_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+    int runtime_level_ = static_cast<int>(LogLevel::Info);
+    std::thread drainer_;
+};
+
+#define CPPWORKER_LOG(level, msg)                                        \
+    do {                                                                 \
+        if (static_cast<int>(level) >= CPPWORKER_MIN_LOG_LEVEL &&        \
+            AsyncLogger::instance().enabled(level)) {                    \
+            std::ostringstream _cppworker_log_oss;                       \
+            _cppworker_log_oss << msg;                                   \
+            AsyncLogger::instance().log(level, _cppworker_log_oss.str()); \
+        }                                                                \
+    } while (0)
+
+#define LOG_DEBUG(msg) CPPWORKER_LOG(LogLevel::Debug, msg)
+#define LOG_INFO(msg) CPPWORKER_LOG(LogLevel::Info, msg)
+#define LOG_WARN(msg) CPPWORKER_LOG(LogLevel::Warn, msg)
+#define LOG_ERROR(msg) CPPWORKER_LOG(LogLevel::Error, msg)
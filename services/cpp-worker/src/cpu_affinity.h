@@ -0,0 +1,83 @@
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Thread placement helpers. On the dual-socket boxes the worker's
+// throughput swings with where the kernel lands the reader and the
+// dispatch threads; pinning them onto one node's CPUs (the one the NIC
+// hangs off) keeps the hub::Message handoff on node-local cache lines.
+// Topology is expressed as explicit CPU lists in env vars — the
+// operator knows the machine, the worker doesn't need libnuma to obey.
+namespace cpu_affinity {
+
+// Parses "0-3,8,10-11" into an explicit CPU list; bad tokens are
+// skipped rather than fatal so a wrong env var degrades to fewer pins,
+// not a dead worker.
+inline std::vector<int> parse_cpuset(const std::string& spec) {
+    std::vector<int> cpus;
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) {
+            comma = spec.size();
+        }
+        std::string token = spec.substr(start, comma - start);
+        start = comma + 1;
+        if (token.empty()) {
+            continue;
+        }
+        size_t dash = token.find('-');
+        char* end = nullptr;
+        if (dash == std::string::npos) {
+            long cpu = std::strtol(token.c_str(), &end, 10);
+            if (end != token.c_str() && cpu >= 0) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        } else {
+            // Both endpoints must parse, same as the single-CPU branch;
+            // otherwise "x-y" would read as 0-0 and pin to CPU 0.
+            std::string lo_token = token.substr(0, dash);
+            std::string hi_token = token.substr(dash + 1);
+            long lo = std::strtol(lo_token.c_str(), &end, 10);
+            bool lo_ok = end != lo_token.c_str();
+            long hi = std::strtol(hi_token.c_str(), &end, 10);
+            bool hi_ok = end != hi_token.c_str();
+            if (!lo_ok || !hi_ok) {
+                continue;
+            }
+            for (long cpu = lo; cpu >= 0 && cpu <= hi; cpu++) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+    }
+    return cpus;
+}
+
+inline std::vector<int> cpuset_from_env(const char* name) {
+    const char* env = std::getenv(name);
+    return env && *env ? parse_cpuset(env) : std::vector<int>{};
+}
+
+// Pins the calling thread to the given CPUs; false if the set was
+// empty or the kernel refused (e.g. cgroup cpuset excludes them).
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+inline bool pin_current_thread(int cpu) {
+    return pin_current_thread(std::vector<int>{cpu});
+}
+
+}  // namespace cpu_affinity
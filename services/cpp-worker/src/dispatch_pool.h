@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cpu_affinity.h"
+
+// Thread pool sitting between the hub stream reader and plugin execution.
+// The reader thread submits one task per request; a fixed set of worker
+// threads drains a bounded MPMC queue so one slow plugin no longer stalls
+// every queued request on the stream. When the queue is full submit()
+// blocks the reader, which pushes backpressure onto the hub via HTTP/2
+// flow control instead of growing memory without bound; try_submit()
+// instead rejects immediately so the caller can shed the request with a
+// retry hint. Two lanes share the capacity: High-lane tasks are drained
+// before Normal ones, and when the pool is full only the High lane may
+// still use the last sixteenth of the queue.
+class DispatchPool {
+public:
+    using Task = std::function<void()>;
+
+    enum class Lane { Normal, High };
+
+    // thread_count == 0 means std::thread::hardware_concurrency().
+    explicit DispatchPool(size_t thread_count = 0, size_t queue_capacity = 1024)
+        : queue_capacity_(queue_capacity), stopping_(false) {
+        thread_count_ = thread_count > 0 ? thread_count
+                                         : std::thread::hardware_concurrency();
+        if (thread_count_ == 0) {
+            thread_count_ = 1;
+        }
+    }
+
+    ~DispatchPool() {
+        stop();
+    }
+
+    // Restricts pool threads to the given CPUs (round-robin across the
+    // list) once start() runs. On a dual-socket box, handing the pool
+    // the CPU list of the NIC's node keeps the reader-to-worker message
+    // handoff on node-local cache lines instead of bouncing across the
+    // interconnect. Empty set (the default) leaves placement to the
+    // kernel.
+    void set_cpuset(std::vector<int> cpus) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpuset_ = std::move(cpus);
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!workers_.empty()) {
+            return;
+        }
+        stopping_ = false;
+        workers_.reserve(thread_count_);
+        for (size_t i = 0; i < thread_count_; i++) {
+            int cpu = cpuset_.empty() ? -1
+                                      : cpuset_[i % cpuset_.size()];
+            workers_.emplace_back([this, cpu] {
+                if (cpu >= 0) {
+                    cpu_affinity::pin_current_thread(cpu);
+                }
+                workerLoop();
+            });
+        }
+    }
+
+    // Drains remaining tasks, then joins the workers.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers_.clear();
+    }
+
+    // Blocks while the queue is full. Returns false only once the pool is
+    // stopping and the task can no longer be accepted.
+    bool submit(Task task) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [this] {
+                return stopping_ || depthLocked() < queue_capacity_;
+            });
+            if (stopping_) {
+                return false;
+            }
+            queue_.push_back(std::move(task));
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Admission control: rejects instead of blocking when the lane's
+    // share of the queue is exhausted, so the reader can answer with a
+    // retry hint in microseconds instead of queueing toward OOM. The
+    // Normal lane is cut off one sixteenth of capacity early, keeping
+    // headroom so High-lane traffic still gets through a full queue.
+    bool try_submit(Task task, Lane lane = Lane::Normal) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return false;
+            }
+            size_t limit = lane == Lane::High
+                               ? queue_capacity_
+                               : queue_capacity_ - queue_capacity_ / 16;
+            if (depthLocked() >= limit) {
+                return false;
+            }
+            if (lane == Lane::High) {
+                high_queue_.push_back(std::move(task));
+            } else {
+                queue_.push_back(std::move(task));
+            }
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Runs body(i) for every i in [0, count), fanned across the pool
+    // with the calling thread participating, and returns once all items
+    // are done (input order is the caller's concern: address results by
+    // index). Helper tasks go through try_submit, so on a saturated pool
+    // this degrades to the caller running everything inline — a pool
+    // thread fanning out its own batch can never deadlock waiting on
+    // pool capacity. body must not throw; catch per item and encode the
+    // failure in the result slot instead.
+    void parallel_for(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) {
+            return;
+        }
+        if (count == 1) {
+            body(0);
+            return;
+        }
+
+        struct Shared {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            size_t count;
+            const std::function<void(size_t)>* body;
+            std::mutex mutex;
+            std::condition_variable all_done;
+        };
+        auto shared = std::make_shared<Shared>();
+        shared->count = count;
+        shared->body = &body;
+
+        auto run = [](const std::shared_ptr<Shared>& s) {
+            size_t i;
+            while ((i = s->next.fetch_add(1, std::memory_order_relaxed)) <
+                   s->count) {
+                (*s->body)(i);
+                if (s->done.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+                    s->count) {
+                    std::lock_guard<std::mutex> lock(s->mutex);
+                    s->all_done.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(thread_count_, count - 1);
+        for (size_t h = 0; h < helpers; h++) {
+            if (!try_submit([run, shared] { run(shared); }, Lane::High)) {
+                break;  // pool saturated; the caller picks up the slack
+            }
+        }
+        run(shared);
+
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->all_done.wait(lock, [&] {
+            return shared->done.load(std::memory_order_acquire) == count;
+        });
+    }
+
+    size_t queue_depth() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return depthLocked();
+    }
+
+    size_t queue_capacity() const { return queue_capacity_; }
+
+    size_t thread_count() const { return thread_count_; }
+
+private:
+    size_t depthLocked() const {
+        return queue_.size() + high_queue_.size();
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_empty_.wait(lock, [this] {
+                    return stopping_ || depthLocked() > 0;
+                });
+                if (depthLocked() == 0) {
+                    return;  // stopping and fully drained
+                }
+                if (!high_queue_.empty()) {
+                    task = std::move(high_queue_.front());
+                    high_queue_.pop_front();
+                } else {
+                    task = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+            }
+            not_full_.notify_one();
+            task();
+        }
+    }
+
+    size_t thread_count_;
+    size_t queue_capacity_;
+    std::vector<int> cpuset_;  // empty = kernel placement
+    bool stopping_;
+    std::deque<Task> queue_;
+    std::deque<Task> high_queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Request payload streamed down from the hub via DownloadFile. Payloads up
+// to the inline threshold are held in one preallocated buffer; larger ones
+// are spilled to a memory-mapped temp file so a 50MB image never sits in
+// the heap as base64 + json string + parsed copy. The mapping and temp
+// file are released when the payload is destroyed (after the response is
+// written).
+class FilePayload {
+public:
+    static constexpr size_t kInlineLimit = 16 * 1024 * 1024;
+
+    std::string file_id;
+    std::string filename;
+    std::string content_type;
+
+    FilePayload() = default;
+    FilePayload(const FilePayload&) = delete;
+    FilePayload& operator=(const FilePayload&) = delete;
+
+    ~FilePayload() {
+        releaseMapping();
+    }
+
+    const char* data() const {
+        return mapped_ ? static_cast<const char*>(mapped_) : inline_data_.data();
+    }
+
+    size_t size() const { return size_; }
+
+    bool is_mapped() const { return mapped_ != nullptr; }
+
+    // Reserves storage once the total size is known (from the first chunk).
+    // total_size < 0 means unknown; the inline buffer grows as chunks land.
+    bool reserve(long long total_size) {
+        if (total_size > static_cast<long long>(kInlineLimit)) {
+            return openMapping(static_cast<size_t>(total_size));
+        }
+        if (total_size > 0) {
+            inline_data_.reserve(static_cast<size_t>(total_size));
+        }
+        return true;
+    }
+
+    bool append(const void* bytes, size_t len) {
+        if (mapped_) {
+            if (size_ + len > mapped_capacity_) {
+                return false;  // hub sent more than total_size promised
+            }
+            std::memcpy(static_cast<char*>(mapped_) + size_, bytes, len);
+        } else {
+            inline_data_.append(static_cast<const char*>(bytes), len);
+        }
+        size_ += len;
+        return true;
+    }
+
+private:
+    bool openMapping(size_t capacity) {
+        char path_template[] = "/tmp/cpp-worker-payload-XXXXXX";
+        fd_ = mkstemp(path_template);
+        if (fd_ < 0) {
+            return false;
+        }
+        temp_path_ = path_template;
+        if (ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+            releaseMapping();
+            return false;
+        }
+        mapped_ = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapped_ == MAP_FAILED) {
+            mapped_ = nullptr;
+            releaseMapping();
+            return false;
+        }
+        mapped_capacity_ = capacity;
+        return true;
+    }
+
+    void releaseMapping() {
+        if (mapped_) {
+            munmap(mapped_, mapped_capacity_);
+            mapped_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        if (!temp_path_.empty()) {
+            unlink(temp_path_.c_str());
+            temp_path_.clear();
+        }
+        mapped_capacity_ = 0;
+    }
+
+    std::string inline_data_;
+    void* mapped_ = nullptr;
+    size_t mapped_capacity_ = 0;
+    size_t size_ = 0;
+    int fd_ = -1;
+    std::string temp_path_;
+};
@@ -1,7 +1,9 @@
 #include "plugin.h"
+#include "plugin_registry.h"
 #include <string>
 
-class HelloCppPlugin : public Plugin {
+// final so call sites holding the concrete type devirtualize execute().
+class HelloCppPlugin final : public Plugin {
 public:
     std::string get_name() const override {
         return "hello_cpp";
@@ -11,7 +13,10 @@ public:
         return "Returns a friendly hello message";
     }
 
+    bool is_deterministic() const override { return true; }
+
     json execute(const json& input, ExecutionContext* context = nullptr) override {
+        (void)context;
         std::string name = input.value("name", "World");
         return {
             {"message", "Hello from C++, " + name + "!"}
@@ -19,6 +24,9 @@ public:
     }
 };
 
+REGISTER_PLUGIN(HelloCppPlugin, "hello_cpp");
+
+// Kept for callers that construct plugins directly (see all_plugins.h).
 PluginPtr create_hello_cpp_plugin() {
     return std::make_shared<HelloCppPlugin>();
 }
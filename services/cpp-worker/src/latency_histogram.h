@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// HDR-style log-linear latency histogram: one power-of-two tier per value
+// magnitude, 16 linear sub-buckets per tier, so relative error stays
+// under ~6% from nanoseconds to minutes with a fixed 2.5KB footprint.
+// record() is a bit-scan plus one relaxed fetch_add (~10-20ns), cheap
+// enough to leave on in production; percentile() walks the buckets and
+// may run concurrently with recording (the result is approximate by
+// design).
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSub = 1 << kSubBits;          // 16
+    static constexpr int kTiers = 40;                   // up to ~2^43 ns
+    static constexpr size_t kBuckets = static_cast<size_t>(kTiers) * kSub;
+
+    void record(uint64_t value_ns) {
+        buckets_[bucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+
+    // p in [0, 1]; returns a representative value in ns.
+    uint64_t percentile(double p) const {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(total * p);
+        if (target >= total) {
+            target = total - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > target) {
+                return bucketValue(i);
+            }
+        }
+        return bucketValue(kBuckets - 1);
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_ns_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static size_t bucketIndex(uint64_t v) {
+        if (v < kSub) {
+            return static_cast<size_t>(v);
+        }
+        int msb = 63 - __builtin_clzll(v);
+        size_t tier = static_cast<size_t>(msb - kSubBits + 1);
+        if (tier >= kTiers) {
+            tier = kTiers - 1;
+            msb = kSubBits + kTiers - 2;
+        }
+        size_t sub = (v >> (msb - kSubBits)) & (kSub - 1);
+        return tier * kSub + sub;
+    }
+
+    static uint64_t bucketValue(size_t index) {
+        size_t tier = index / kSub;
+        uint64_t sub = index % kSub;
+        if (tier == 0) {
+            return sub;
+        }
+        int shift = static_cast<int>(tier) - 1;
+        // Midpoint of the bucket's range.
+        uint64_t base = (static_cast<uint64_t>(kSub) + sub) << shift;
+        return base + (1ull << shift) / 2;
+    }
+
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+};
@@ -1,18 +1,87 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <memory>
 #include <nlohmann/json.hpp>
 
-using json = nlohmann::json;
+#include "file_payload.h"
+#include "request_arena.h"
+
+// Same API and wire format as nlohmann::json, but node storage goes
+// through the per-request arena when one is in scope (see request_arena.h).
+using json = arena_json;
 
 class ExecutionContext {
 public:
     std::string worker_id;
-    // Callback for calling other workers
-    // std::function<json(std::string, std::string, json)> call_worker;
+    // Payload streamed down via DownloadFile when the request carries a
+    // file_id (see FilePayload for the inline vs memory-mapped storage).
+    std::shared_ptr<FilePayload> file;
+    // Streams data up to the hub, returning the file_id for the response.
+    std::function<std::string(const std::string& data,
+                              const std::string& filename,
+                              const std::string& content_type)> upload_file;
+    // Issues a worker-to-worker call through the hub (WORKER_CALL over
+    // the existing stream, correlated by call id). Returns a future so a
+    // plugin can launch several downstream calls concurrently and await
+    // them together; each call carries its own deadline.
+    std::function<std::future<json>(const std::string& target_worker,
+                                    const std::string& capability,
+                                    json params,
+                                    std::chrono::milliseconds deadline)> call_worker;
+    // Runs body(i) for i in [0, count) across the worker's dispatch pool
+    // (caller thread included) and returns when every item is done.
+    // Plugins use this for the map step of batch requests; body must not
+    // throw — catch per item and record the failure in that result slot.
+    // Unset when the worker runs without a pool.
+    std::function<void(size_t count,
+                       const std::function<void(size_t)>& body)> parallel_for;
+    // Absolute deadline derived from Message.metadata["deadline_ms"] at
+    // admission, so queue wait counts against it. Default-constructed
+    // time_point means the caller set none.
+    std::chrono::steady_clock::time_point deadline{};
+    // Cooperative cancellation: the worker flips this once the request
+    // is abandoned (caller gone, stream torn down). Plugins treat it
+    // like an expired deadline.
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    // Request-scoped bump allocator, set by the dispatch layer and reset
+    // wholesale once the response is written. json values built during
+    // execute() land here automatically; anything a plugin wants to keep
+    // past the request (caches, registries) must be deep-copied outside
+    // a RequestArena::Scope or it dangles after reset.
+    RequestArena* arena = nullptr;
+
+    bool has_deadline() const {
+        return deadline != std::chrono::steady_clock::time_point{};
+    }
+
+    // Time left before the caller stops listening; zero once expired,
+    // max() without a deadline. Long-running plugins should check this
+    // (or expired()) between work items and give up early — finishing
+    // work nobody reads just burns CPU during overload.
+    std::chrono::milliseconds remaining() const {
+        if (!has_deadline()) {
+            return std::chrono::milliseconds::max();
+        }
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        return left.count() > 0 ? left : std::chrono::milliseconds(0);
+    }
+
+    bool expired() const {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return has_deadline() &&
+               std::chrono::steady_clock::now() >= deadline;
+    }
 };
 
 class Plugin {
@@ -25,6 +94,19 @@ public:
     virtual bool accepts_file() const { return false; }
     virtual std::string get_file_field_name() const { return "file"; }
     
+    // Pure function of its params: same params, same result, no side
+    // effects. Opts the plugin into the result cache (see ResultCache);
+    // plugins touching files, other workers, or ambient state must keep
+    // the default.
+    virtual bool is_deterministic() const { return false; }
+
+    // Heavyweight startup state (models, dictionaries) belongs here, not
+    // in the constructor: the manager runs warm_up() on a background
+    // thread right after registration, so the capability is advertised
+    // to the hub immediately and only requests arriving before warm-up
+    // finishes wait for it (see PluginManager). Called at most once.
+    virtual void warm_up() {}
+
     // New method for worker-grpc.cpp
     virtual std::string getName() const { return get_name(); }
     virtual std::string getDescription() const { return get_description(); }
@@ -32,6 +114,24 @@ public:
     virtual std::vector<std::string> getOptionalParams() const { return {}; }
     
     virtual json execute(const json& params, ExecutionContext* context = nullptr) = 0;
+
+    // Zero-copy entry point: the raw request content, unparsed. A plugin
+    // returning true from supports_raw() gets the view handed to its
+    // execute_raw() override and can run an on-demand parser over it
+    // instead of paying a DOM parse; for everyone else the manager
+    // materializes the params once — including the legacy
+    // {"params": ...} unwrap — and calls execute() (see dispatchRaw in
+    // plugin_manager.cpp). The base execute_raw does the same unwrap so
+    // a plugin opting in without overriding it still behaves correctly.
+    virtual bool supports_raw() const { return false; }
+    virtual json execute_raw(std::string_view content,
+                             ExecutionContext* context = nullptr) {
+        json params = json::parse(content);
+        if (params.contains("params")) {
+            params = std::move(params["params"]);
+        }
+        return execute(params, context);
+    }
 };
 
 using PluginPtr = std::shared_ptr<Plugin>;
@@ -1,27 +1,328 @@
 #include "plugin_manager.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <stdexcept>
+#include <thread>
 
-void PluginManager::register_plugin(PluginPtr plugin) {
-    plugins_[plugin->get_name()] = plugin;
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+
+namespace {
+
+// Wraps one plugin invocation with the per-plugin counters/histogram.
+template <typename Fn>
+json timedCall(PluginStats& stats, Fn&& fn) {
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        json result = fn();
+        uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        stats.total_latency_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+        stats.latency.record(elapsed_ns);
+        return result;
+    } catch (...) {
+        uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        stats.total_latency_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+        stats.latency.record(elapsed_ns);
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
 }
 
-Plugin* PluginManager::get_plugin(const std::string& name) {
-    auto it = plugins_.find(name);
-    if (it != plugins_.end()) {
-        return it->second.get();
+// Shared-library plugins export this under C linkage so the symbol is
+// findable by name; same contract as the built-in create_*_plugin
+// factories, just without the per-plugin name.
+using PluginFactory = PluginPtr (*)();
+
+// dlopens path and runs its factory. The handle is never dlclose'd —
+// the plugin's vtable and code live in the mapping — so it is either
+// parked in dl_handles_ by the caller or deliberately leaked.
+PluginPtr createFromLibrary(const std::string& path, void** handle_out) {
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        throw std::runtime_error("dlopen failed for " + path + ": " + dlerror());
+    }
+    auto factory = reinterpret_cast<PluginFactory>(dlsym(handle, "create_plugin"));
+    if (!factory) {
+        dlclose(handle);
+        throw std::runtime_error("no create_plugin symbol in " + path);
+    }
+    PluginPtr plugin = factory();
+    if (!plugin) {
+        throw std::runtime_error("create_plugin returned null in " + path);
+    }
+    if (handle_out) {
+        *handle_out = handle;
+    }
+    return plugin;
+}
+
+// Everything registration needs to advertise the capability, captured
+// once so later startups can skip instantiating the plugin.
+json capabilityManifest(const Plugin& plugin) {
+    return {
+        {"name", plugin.get_name()},
+        {"description", plugin.get_description()},
+        {"http_method", plugin.get_http_method()},
+        {"accepts_file", plugin.accepts_file()},
+        {"file_field_name", plugin.get_file_field_name()},
+        {"required_params", plugin.getRequiredParams()},
+        {"optional_params", plugin.getOptionalParams()}
+    };
+}
+
+// Registered from a fresh manifest entry: serves all the metadata
+// getters from the cached capability record and only dlopens the
+// backing .so on the first execute. A failed load throws into the
+// caller (counted as a plugin error) and is retried on the next call.
+class LazyPlugin : public Plugin {
+public:
+    LazyPlugin(std::string path, json capability)
+        : path_(std::move(path)), capability_(std::move(capability)) {}
+
+    std::string get_name() const override {
+        return capability_.value("name", "");
+    }
+    std::string get_description() const override {
+        return capability_.value("description", "");
+    }
+    std::string get_http_method() const override {
+        return capability_.value("http_method", "POST");
+    }
+    bool accepts_file() const override {
+        return capability_.value("accepts_file", false);
+    }
+    std::string get_file_field_name() const override {
+        return capability_.value("file_field_name", "file");
+    }
+    std::vector<std::string> getRequiredParams() const override {
+        return paramList("required_params");
+    }
+    std::vector<std::string> getOptionalParams() const override {
+        return paramList("optional_params");
+    }
+
+    json execute(const json& params, ExecutionContext* context = nullptr) override {
+        return target()->execute(params, context);
+    }
+    json execute_raw(std::string_view content,
+                     ExecutionContext* context = nullptr) override {
+        return target()->execute_raw(content, context);
+    }
+
+private:
+    std::vector<std::string> paramList(const char* key) const {
+        auto it = capability_.find(key);
+        if (it == capability_.end() || !it->is_array()) {
+            return {};
+        }
+        return it->get<std::vector<std::string>>();
+    }
+
+    // Reports the backing plugin's answer once it has been loaded;
+    // before that the manager takes the parsed path, whose first call
+    // loads it.
+    bool supports_raw() const override {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        return real_ && real_->supports_raw();
+    }
+
+    Plugin* target() {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        if (!real_) {
+            real_ = createFromLibrary(path_, nullptr);
+        }
+        return real_.get();
+    }
+
+    std::string path_;
+    json capability_;
+    mutable std::mutex load_mutex_;
+    PluginPtr real_;
+};
+
+json readManifest(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return json::object();
+    }
+    try {
+        json manifest = json::parse(in);
+        return manifest.is_object() ? manifest : json::object();
+    } catch (const json::exception&) {
+        return json::object();  // stale or corrupt cache: rebuild it
+    }
+}
+
+void writeManifest(const std::string& path, const json& manifest) {
+    std::ofstream out(path);
+    if (out) {
+        out << manifest.dump(2) << "\n";
+    }
+}
+
+bool endsWith(const std::string& value, const char* suffix) {
+    size_t n = std::char_traits<char>::length(suffix);
+    return value.size() >= n &&
+           value.compare(value.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+namespace {
+
+// Result-cache byte budget (RESULT_CACHE_MB, default 64, 0 disables).
+size_t cacheBudgetFromEnv() {
+    const char* env = std::getenv("RESULT_CACHE_MB");
+    if (env) {
+        long mb = std::atol(env);
+        if (mb >= 0) {
+            return static_cast<size_t>(mb) * 1024 * 1024;
+        }
+    }
+    return 64u * 1024 * 1024;
+}
+
+// Raw dispatch honors Plugin::supports_raw(): opted-in plugins get the
+// unparsed view, everyone else gets their params materialized here once
+// — including the legacy {"params": ...} unwrap — and goes through
+// execute(), so the parse lives in one place instead of each plugin's
+// base-class fallback.
+json dispatchRaw(Plugin& plugin, std::string_view content,
+                 ExecutionContext* context) {
+    if (plugin.supports_raw()) {
+        return plugin.execute_raw(content, context);
+    }
+    json params = json::parse(content);
+    if (params.contains("params")) {
+        params = std::move(params["params"]);
+    }
+    return plugin.execute(params, context);
+}
+
+}  // namespace
+
+PluginManager::PluginManager()
+    : registry_(std::make_shared<const Registry>()),
+      result_cache_(cacheBudgetFromEnv()) {
+    // Builtins declared with REGISTER_PLUGIN self-registered into the
+    // static-init table. Constructors run fanned across threads — with
+    // heavyweight plugin sets they dominate cold start — while anything
+    // heavier still goes in warm_up(), launched per plugin below so
+    // registration never waits on it.
+    const auto& builtins = plugin_registry::builtins();
+    std::vector<PluginPtr> built(builtins.size());
+    std::atomic<size_t> next{0};
+    auto construct = [&] {
+        size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) <
+               builtins.size()) {
+            built[i] = builtins[i].factory();
+        }
+    };
+    size_t helper_count = std::min(
+        builtins.size() > 0 ? builtins.size() - 1 : 0,
+        static_cast<size_t>(std::thread::hardware_concurrency()));
+    std::vector<std::thread> helpers;
+    helpers.reserve(helper_count);
+    for (size_t h = 0; h < helper_count; h++) {
+        helpers.emplace_back(construct);
+    }
+    construct();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+
+    for (PluginPtr& plugin : built) {
+        Plugin* raw = plugin.get();
+        register_plugin(std::move(plugin),
+                        std::async(std::launch::async,
+                                   [raw] { raw->warm_up(); }).share());
+    }
+}
+
+std::shared_ptr<const PluginManager::Registry> PluginManager::snapshot() const {
+    return std::atomic_load(&registry_);
+}
+
+const PluginManager::PluginEntry* PluginManager::find_entry(
+        const std::string& name,
+        std::shared_ptr<const Registry>& keep_alive) {
+    keep_alive = snapshot();
+    auto it = keep_alive->find(plugin_registry::fnv1a(name));
+    if (it != keep_alive->end() && it->second.name == name) {
+        return &it->second;
+    }
+
+    // Miss: a new .so may have been dropped into the plugin directory
+    // since the last scan, so rescan once before giving up. The scan is
+    // an opendir plus stat per file and only runs for unknown
+    // capabilities, so the hot path never pays for it.
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        dir = plugin_dir_;
+    }
+    if (!dir.empty()) {
+        load_directory(dir);
+        keep_alive = snapshot();
+        it = keep_alive->find(plugin_registry::fnv1a(name));
+        if (it != keep_alive->end() && it->second.name == name) {
+            return &it->second;
+        }
     }
     return nullptr;
 }
 
+void PluginManager::register_plugin(PluginPtr plugin,
+                                    std::shared_future<void> ready) {
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    auto current = snapshot();
+    auto next = std::make_shared<Registry>(*current);
+
+    std::string name = plugin->get_name();
+    uint32_t key = plugin_registry::fnv1a(name);
+    auto existing = current->find(key);
+    if (existing != current->end() && existing->second.name != name) {
+        // Two distinct capabilities hashing alike would shadow each
+        // other; with a handful of plugins this should never fire.
+        throw std::runtime_error("Capability name hash collision: " + name +
+                                 " vs " + existing->second.name);
+    }
+    PluginEntry entry;
+    entry.name = name;
+    entry.plugin = std::move(plugin);
+    // Re-registering a plugin keeps its counters.
+    entry.stats = existing != current->end() ? existing->second.stats
+                                             : std::make_shared<PluginStats>();
+    entry.ready = std::move(ready);
+    (*next)[key] = std::move(entry);
+
+    std::atomic_store(&registry_,
+                      std::shared_ptr<const Registry>(std::move(next)));
+}
+
+Plugin* PluginManager::get_plugin(const std::string& name) {
+    std::shared_ptr<const Registry> keep_alive;
+    const PluginEntry* entry = find_entry(name, keep_alive);
+    return entry ? entry->plugin.get() : nullptr;
+}
+
 std::vector<json> PluginManager::get_capabilities() {
     std::vector<json> caps;
-    for (const auto& pair : plugins_) {
+    auto current = snapshot();
+    for (const auto& pair : *current) {
         json cap = {
-            {"name", pair.second->get_name()},
-            {"description", pair.second->get_description()},
-            {"http_method", pair.second->get_http_method()},
-            {"accepts_file", pair.second->accepts_file()},
-            {"file_field_name", pair.second->get_file_field_name()}
+            {"name", pair.second.plugin->get_name()},
+            {"description", pair.second.plugin->get_description()},
+            {"http_method", pair.second.plugin->get_http_method()},
+            {"accepts_file", pair.second.plugin->accepts_file()},
+            {"file_field_name", pair.second.plugin->get_file_field_name()}
         };
         caps.push_back(cap);
     }
@@ -30,20 +331,209 @@ std::vector<json> PluginManager::get_capabilities() {
 
 std::vector<Plugin*> PluginManager::getAllPlugins() const {
     std::vector<Plugin*> result;
-    for (const auto& pair : plugins_) {
-        result.push_back(pair.second.get());
+    auto current = snapshot();
+    for (const auto& pair : *current) {
+        result.push_back(pair.second.plugin.get());
     }
     return result;
 }
 
 std::string PluginManager::execute(const std::string& capability, const std::string& params) {
-    Plugin* plugin = get_plugin(capability);
-    if (!plugin) {
+    return execute(capability, json::parse(params)).dump();
+}
+
+json PluginManager::execute(const std::string& capability, json&& params,
+                            ExecutionContext* context) {
+    std::shared_ptr<const Registry> keep_alive;
+    const PluginEntry* entry = find_entry(capability, keep_alive);
+    if (!entry) {
+        throw std::runtime_error("Plugin not found: " + capability);
+    }
+    // Requests arriving before warm_up() finished queue here; a failed
+    // warm-up re-throws into every caller.
+    if (entry->ready.valid()) {
+        entry->ready.get();
+    }
+
+    return timedCall(*entry->stats, [&] {
+        return entry->plugin->execute(params, context);
+    });
+}
+
+json PluginManager::execute_raw(const std::string& capability,
+                                std::string_view content,
+                                ExecutionContext* context) {
+    std::shared_ptr<const Registry> keep_alive;
+    const PluginEntry* entry = find_entry(capability, keep_alive);
+    if (!entry) {
         throw std::runtime_error("Plugin not found: " + capability);
     }
-    
-    json params_json = json::parse(params);
-    json result = plugin->execute(params_json);
-    
-    return result.dump();
+    if (entry->ready.valid()) {
+        entry->ready.get();
+    }
+
+    return timedCall(*entry->stats, [&] {
+        return dispatchRaw(*entry->plugin, content, context);
+    });
+}
+
+void PluginManager::execute_raw_serialized(const std::string& capability,
+                                           std::string_view content,
+                                           ExecutionContext* context,
+                                           std::string& result_out) {
+    std::shared_ptr<const Registry> keep_alive;
+    const PluginEntry* entry = find_entry(capability, keep_alive);
+    if (!entry) {
+        throw std::runtime_error("Plugin not found: " + capability);
+    }
+    if (entry->ready.valid()) {
+        entry->ready.get();
+    }
+
+    bool cacheable = result_cache_.enabled() &&
+                     entry->plugin->is_deterministic() &&
+                     (!context || !context->file);
+    uint64_t key = 0;
+    if (cacheable) {
+        key = ResultCache::digest(capability, content);
+        if (ResultCache::Value hit = result_cache_.get(key, capability,
+                                                      content)) {
+            entry->stats->cache_hits.fetch_add(1, std::memory_order_relaxed);
+            result_out = *hit;
+            return;
+        }
+    }
+
+    json result = timedCall(*entry->stats, [&] {
+        return dispatchRaw(*entry->plugin, content, context);
+    });
+    result_out = result.dump();
+    if (cacheable) {
+        result_cache_.put(key, capability, content,
+                          std::make_shared<const std::string>(result_out));
+    }
+}
+
+json PluginManager::get_statistics() const {
+    json stats = json::object();
+    auto current = snapshot();
+    for (const auto& pair : *current) {
+        uint64_t calls = pair.second.stats->calls.load(std::memory_order_relaxed);
+        uint64_t errors = pair.second.stats->errors.load(std::memory_order_relaxed);
+        uint64_t latency_ns =
+            pair.second.stats->total_latency_ns.load(std::memory_order_relaxed);
+        const LatencyHistogram& histogram = pair.second.stats->latency;
+        stats[pair.second.name] = {
+            {"calls", calls},
+            {"errors", errors},
+            {"cache_hits",
+             pair.second.stats->cache_hits.load(std::memory_order_relaxed)},
+            {"total_latency_ns", latency_ns},
+            {"avg_latency_us", calls ? (latency_ns / calls) / 1000.0 : 0.0},
+            {"p50_us", histogram.percentile(0.50) / 1000.0},
+            {"p95_us", histogram.percentile(0.95) / 1000.0},
+            {"p99_us", histogram.percentile(0.99) / 1000.0}
+        };
+    }
+    return stats;
+}
+
+size_t PluginManager::plugin_count() const {
+    return snapshot()->size();
+}
+
+size_t PluginManager::load_directory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    // Rescans can run on a dispatch thread (rescan-on-miss), but the
+    // registry and cached manifests outlive the triggering request —
+    // suspend its arena so their json lands on the heap.
+    RequestArena::Scope heap_scope(nullptr);
+    plugin_dir_ = dir;
+
+    DIR* dp = opendir(dir.c_str());
+    if (!dp) {
+        return 0;
+    }
+
+    const std::string manifest_path = dir + "/capabilities.json";
+    json manifest = readManifest(manifest_path);
+    json next_manifest = json::object();
+    size_t loaded = 0;
+    bool manifest_dirty = false;
+
+    struct dirent* entry;
+    while ((entry = readdir(dp)) != nullptr) {
+        std::string name = entry->d_name;
+        if (!endsWith(name, ".so")) {
+            continue;
+        }
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        long mtime = static_cast<long>(st.st_mtime);
+
+        auto seen = seen_.find(path);
+        if (seen != seen_.end() && seen->second == mtime) {
+            // Already registered this build of the library.
+            if (manifest.contains(name)) {
+                next_manifest[name] = manifest[name];
+            }
+            continue;
+        }
+
+        try {
+            auto cached = manifest.find(name);
+            if (seen == seen_.end() && cached != manifest.end() &&
+                cached->value("mtime", -1L) == mtime) {
+                // Fresh manifest entry: register from the cached
+                // capability record and defer the dlopen to first use.
+                register_plugin(std::make_shared<LazyPlugin>(
+                    path, (*cached)["capability"]));
+                next_manifest[name] = *cached;
+                LOG_INFO("Registered plugin from manifest cache: " + path);
+            } else {
+                void* handle = nullptr;
+                PluginPtr plugin = createFromLibrary(path, &handle);
+                next_manifest[name] = {
+                    {"mtime", mtime},
+                    {"capability", capabilityManifest(*plugin)}
+                };
+                register_plugin(std::move(plugin));
+                dl_handles_.push_back(handle);
+                manifest_dirty = true;
+                LOG_INFO("Loaded plugin library: " + path);
+            }
+            seen_[path] = mtime;
+            ++loaded;
+        } catch (const std::exception& e) {
+            LOG_WARN(std::string("Skipping plugin library: ") + e.what());
+        }
+    }
+    closedir(dp);
+
+    if (manifest_dirty || next_manifest != manifest) {
+        writeManifest(manifest_path, next_manifest);
+    }
+    return loaded;
+}
+
+bool PluginManager::load_shared_plugin(const std::string& path) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    try {
+        void* handle = nullptr;
+        PluginPtr plugin = createFromLibrary(path, &handle);
+        register_plugin(std::move(plugin));
+        dl_handles_.push_back(handle);
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            seen_[path] = static_cast<long>(st.st_mtime);
+        }
+        LOG_INFO("Loaded plugin library: " + path);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARN(std::string("Failed to load plugin library: ") + e.what());
+        return false;
+    }
 }
@@ -1,19 +1,106 @@
 #pragma once
 
 #include "plugin.h"
+#include "plugin_registry.h"
+#include "latency_histogram.h"
+#include "result_cache.h"
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <vector>
+#include <mutex>
 #include <unordered_map>
 #include <memory>
 
+// Per-plugin counters and execute-latency histogram, updated with relaxed
+// atomics on the request path and readable at any time without stopping
+// the world. The stats object is shared across registry snapshots so
+// counts survive re-registration.
+struct PluginStats {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> cache_hits{0};
+    std::atomic<uint64_t> total_latency_ns{0};
+    LatencyHistogram latency;
+};
+
+// The registry is an immutable snapshot swapped RCU-style: registration
+// (rare) copies the map under a mutex and publishes it with an atomic
+// store; lookup (per-request, on every dispatch thread) is a wait-free
+// atomic load plus a find on the snapshot. The map is keyed by the
+// FNV-1a hash of the capability name (see plugin_registry.h), so a
+// lookup costs one cheap byte-wise hash instead of std::hash over a
+// std::string, and callers with literal names fold the hash at compile
+// time. Plugins are only ever added, so a Plugin* stays valid for the
+// process lifetime. The constructor instantiates everything the
+// REGISTER_PLUGIN static-init table declared — constructors run in
+// parallel across threads, and each plugin's warm_up() continues on a
+// background thread so registration (and capability advertisement) does
+// not wait for heavyweight state; execute paths block on the per-entry
+// ready future until warm-up completes.
 class PluginManager {
 public:
-    void register_plugin(PluginPtr plugin);
+    PluginManager();
+
+    // ready (optional) gates execution of this plugin until it resolves;
+    // the capability is advertised regardless, so early requests queue
+    // on the future instead of delaying registration.
+    void register_plugin(PluginPtr plugin,
+                         std::shared_future<void> ready = {});
     Plugin* get_plugin(const std::string& name);
     std::vector<json> get_capabilities();
     std::vector<Plugin*> getAllPlugins() const;
     std::string execute(const std::string& capability, const std::string& params);
-    size_t plugin_count() const { return plugins_.size(); }
+    json execute(const std::string& capability, json&& params,
+                 ExecutionContext* context = nullptr);
+    // Hands the raw content to the plugin without parsing it here; see
+    // Plugin::execute_raw for the opt-in zero-copy contract.
+    json execute_raw(const std::string& capability, std::string_view content,
+                     ExecutionContext* context = nullptr);
+    // Request fast path: fills result_out with the plugin result already
+    // dumped. Deterministic plugins (Plugin::is_deterministic) are
+    // served from the result cache on repeated params — a hit reuses the
+    // cached serialized string and skips the plugin and all JSON work.
+    // Requests carrying a file payload bypass the cache.
+    void execute_raw_serialized(const std::string& capability,
+                                std::string_view content,
+                                ExecutionContext* context,
+                                std::string& result_out);
+    // Per-plugin {calls, errors, total_latency_ns, avg_latency_us}.
+    json get_statistics() const;
+    size_t plugin_count() const;
+
+    // dlopen-based loading: scans dir for .so files exposing the
+    // extern "C" PluginPtr create_plugin() factory ABI. A capabilities
+    // manifest (capabilities.json in the same dir, keyed by mtime) lets
+    // fresh entries register lazily — the .so is only dlopen'd on first
+    // execute, so startup registration doesn't instantiate every plugin.
+    // get_plugin() rescans the directory on a miss, so dropping a new
+    // .so in place hot-adds the capability without a restart.
+    size_t load_directory(const std::string& dir);
+    bool load_shared_plugin(const std::string& path);
 
 private:
-    std::unordered_map<std::string, PluginPtr> plugins_;
+    struct PluginEntry {
+        std::string name;  // collision check against the hash key
+        PluginPtr plugin;
+        std::shared_ptr<PluginStats> stats;
+        // Invalid future == ready now; otherwise execution waits on it
+        // (and re-throws a failed warm_up on every call).
+        std::shared_future<void> ready;
+    };
+    using Registry = std::unordered_map<uint32_t, PluginEntry>;
+
+    std::shared_ptr<const Registry> snapshot() const;
+    const PluginEntry* find_entry(const std::string& name,
+                                  std::shared_ptr<const Registry>& keep_alive);
+
+    std::shared_ptr<const Registry> registry_;
+    std::mutex register_mutex_;  // serializes the rare snapshot swaps
+    ResultCache result_cache_;   // budget via RESULT_CACHE_MB, 0 disables
+
+    std::string plugin_dir_;     // rescanned on lookup miss for hot-adds
+    std::mutex load_mutex_;      // serializes directory scans
+    std::unordered_map<std::string, long> seen_;  // path -> mtime already registered
+    std::vector<void*> dl_handles_;  // kept open for the process lifetime
 };
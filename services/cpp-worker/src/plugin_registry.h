@@ -0,0 +1,61 @@
+#pragma once
+
+#include "plugin.h"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Compile-time plugin registration. A plugin TU declares
+//
+//     REGISTER_PLUGIN(StringOpsPlugin, "string_ops");
+//
+// and a PluginRegistrar<StringOpsPlugin> instance appends the plugin's
+// descriptor — name literal, its FNV-1a hash folded at compile time, and
+// a monomorphic factory — to the builtin table during static init.
+// PluginManager instantiates the table in its constructor, so adding a
+// plugin no longer means editing the worker constructors, and capability
+// lookups key on the precomputed hash instead of re-hashing the name
+// string through std::hash on every request. Plugin classes registered
+// this way should be marked final: the factory names the concrete type,
+// which lets the compiler devirtualize execute() at the call sites that
+// still hold the concrete class.
+
+namespace plugin_registry {
+
+// FNV-1a, constexpr so name literals hash at compile time.
+constexpr uint32_t fnv1a(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+struct BuiltinPlugin {
+    const char* name;
+    uint32_t name_hash;
+    PluginPtr (*factory)();
+};
+
+// Static-init ordering safe: first registrar constructs the vector.
+inline std::vector<BuiltinPlugin>& builtins() {
+    static std::vector<BuiltinPlugin> table;
+    return table;
+}
+
+template <typename T>
+struct PluginRegistrar {
+    explicit PluginRegistrar(const char* name) {
+        builtins().push_back(BuiltinPlugin{
+            name, fnv1a(name),
+            [] { return PluginPtr(std::make_shared<T>()); }});
+    }
+};
+
+}  // namespace plugin_registry
+
+#define REGISTER_PLUGIN(Type, name)                                       \
+    static const ::plugin_registry::PluginRegistrar<Type>                 \
+        plugin_registrar_##Type{name}
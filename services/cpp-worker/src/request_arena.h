@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Per-request bump-pointer arena. Building and tearing down a request's
+// json DOMs costs thousands of malloc/free pairs through the global
+// allocator; with the arena every node allocation is a pointer bump into
+// request-owned chunks, freeing is a no-op, and the whole request's
+// memory is reclaimed with one reset() once the response is written.
+// Chunks are kept across resets, so a dispatch thread's hot request
+// memory stays cache-resident from one request to the next.
+//
+// The dispatch layer owns one arena per dispatch thread and installs it
+// with RequestArena::Scope around plugin execution; the `json` alias in
+// plugin.h routes node allocations to whichever arena is in scope on
+// the current thread, and falls back to the global allocator when none
+// is (startup, reader threads, parallel_for helpers).
+class RequestArena {
+public:
+    explicit RequestArena(size_t chunk_bytes = 64 * 1024)
+        : chunk_bytes_(chunk_bytes) {}
+
+    // Bump-allocates; grows by whole chunks when the current one is
+    // exhausted (oversized requests get a dedicated chunk).
+    void* allocate(size_t bytes) {
+        bytes = (bytes + kAlign - 1) & ~(kAlign - 1);
+        while (chunk_index_ < chunks_.size()) {
+            Chunk& chunk = chunks_[chunk_index_];
+            if (offset_ + bytes <= chunk.size) {
+                void* ptr = chunk.data.get() + offset_;
+                offset_ += bytes;
+                return ptr;
+            }
+            chunk_index_++;
+            offset_ = 0;
+        }
+        size_t size = bytes > chunk_bytes_ ? bytes : chunk_bytes_;
+        chunks_.push_back(Chunk{std::unique_ptr<char[]>(new char[size]), size});
+        chunk_index_ = chunks_.size() - 1;
+        offset_ = bytes;
+        return chunks_.back().data.get();
+    }
+
+    // Wholesale reclaim: one pointer reset, chunks stay allocated.
+    void reset() {
+        chunk_index_ = 0;
+        offset_ = 0;
+    }
+
+    size_t bytes_reserved() const {
+        size_t total = 0;
+        for (const Chunk& chunk : chunks_) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+    // The arena the current thread's allocations go to (null = global
+    // allocator).
+    static RequestArena* current() { return current_slot(); }
+
+    // Installs (or, with nullptr, suspends) the thread's arena for the
+    // enclosing block. Suspension matters where a request-path call can
+    // create state that outlives the request, e.g. the plugin registry
+    // rescan.
+    class Scope {
+    public:
+        explicit Scope(RequestArena* arena) : previous_(current_slot()) {
+            current_slot() = arena;
+        }
+        ~Scope() { current_slot() = previous_; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestArena* previous_;
+    };
+
+private:
+    static constexpr size_t kAlign = alignof(std::max_align_t);
+
+    static RequestArena*& current_slot() {
+        static thread_local RequestArena* current = nullptr;
+        return current;
+    }
+
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t chunk_bytes_;
+    std::vector<Chunk> chunks_;
+    size_t chunk_index_ = 0;
+    size_t offset_ = 0;
+};
+
+// Allocator handed to nlohmann: arena when one is in scope, global
+// allocator otherwise. Each block carries a one-word tag saying which,
+// so a value allocated on one thread (or before a scope) frees
+// correctly on another — deallocation trusts the block, not the
+// thread-local state at free time. Arena blocks must not outlive their
+// request: the tag (like the data) is gone after reset().
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = kHeader + n * sizeof(T);
+        RequestArena* arena = RequestArena::current();
+        void* raw = arena ? arena->allocate(bytes) : ::operator new(bytes);
+        *static_cast<uintptr_t*>(raw) = arena ? kArenaTag : kHeapTag;
+        return reinterpret_cast<T*>(static_cast<char*>(raw) + kHeader);
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        char* raw = reinterpret_cast<char*>(ptr) - kHeader;
+        if (*reinterpret_cast<uintptr_t*>(raw) == kHeapTag) {
+            ::operator delete(raw);
+        }
+        // Arena blocks are reclaimed wholesale by RequestArena::reset().
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+
+private:
+    static constexpr size_t kHeader = alignof(std::max_align_t);
+    static constexpr uintptr_t kArenaTag = 0x41524e41;  // "ARNA"
+    static constexpr uintptr_t kHeapTag = 0x48454150;   // "HEAP"
+};
+
+// The repo-wide json type (aliased as `json` in plugin.h): identical to
+// nlohmann::json except that object/array/value nodes allocate through
+// ArenaAllocator. Strings stay std::string so dump()/parse() and every
+// std::string call site interoperate unchanged.
+using arena_json = nlohmann::basic_json<std::map, std::vector, std::string,
+                                        bool, std::int64_t, std::uint64_t,
+                                        double, ArenaAllocator>;
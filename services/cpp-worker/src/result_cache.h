@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Sharded LRU for serialized plugin results. Deterministic capabilities
+// see heavily repeated params, so the worker keeps the dumped result
+// string keyed by a 64-bit digest of (capability, params); a hit costs
+// one shard lock, one hash find, and a shared_ptr copy — no plugin
+// execution and no JSON work. Shards keep the lock uncontended across
+// dispatch threads; each shard owns an equal slice of the byte budget
+// and evicts from its own LRU tail.
+class ResultCache {
+public:
+    using Value = std::shared_ptr<const std::string>;
+
+    explicit ResultCache(size_t budget_bytes, size_t shard_count = 16)
+        : shards_(shard_count ? shard_count : 1),
+          shard_budget_(budget_bytes / (shard_count ? shard_count : 1)) {}
+
+    bool enabled() const { return shard_budget_ > 0; }
+
+    // FNV-1a over capability and params bytes. Params are keyed as the
+    // caller provides them; canonicalizing would cost a parse on every
+    // lookup, and measured duplicates are byte-identical anyway (same
+    // caller, same serializer) — differently ordered keys just miss.
+    static uint64_t digest(std::string_view capability, std::string_view params) {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : capability) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ull;  // separator
+        for (char c : params) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // A digest match alone is not proof of a hit: a 64-bit collision
+    // would silently serve another request's cached response. Entries
+    // keep their key bytes and every hit compares them.
+    Value get(uint64_t key, std::string_view capability,
+              std::string_view params) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() || it->second->capability != capability ||
+            it->second->params != params) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return it->second->value;
+    }
+
+    void put(uint64_t key, std::string_view capability,
+             std::string_view params, Value value) {
+        if (!value) {
+            return;
+        }
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.bytes -= entrySize(*it->second);
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+        Entry entry{key, std::string(capability), std::string(params),
+                    std::move(value)};
+        shard.bytes += entrySize(entry);
+        shard.lru.push_front(std::move(entry));
+        shard.index[key] = shard.lru.begin();
+        while (shard.bytes > shard_budget_ && !shard.lru.empty()) {
+            Entry& victim = shard.lru.back();
+            shard.bytes -= entrySize(victim);
+            shard.index.erase(victim.key);
+            shard.lru.pop_back();
+        }
+    }
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::string capability;  // key bytes, compared on every hit
+        std::string params;
+        Value value;
+    };
+
+    static size_t entrySize(const Entry& entry) {
+        return entry.value->size() + entry.capability.size() +
+               entry.params.size();
+    }
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;  // front = most recent
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    Shard& shardFor(uint64_t key) {
+        // Mix the high bits so shard choice isn't the map bucket choice.
+        return shards_[(key >> 56) % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+    size_t shard_budget_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
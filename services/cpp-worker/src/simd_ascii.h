@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_ASCII_X86 1
+#endif
+
+// Vectorized ASCII kernels for the string_ops plugin. Case conversion
+// flips bit 0x20 on bytes inside the target range, which vectorizes to a
+// compare + and + xor per 16/32 bytes instead of one std::toupper call
+// through a function pointer per byte. The top-level entry points pick
+// AVX2, SSE2, or scalar at runtime.
+namespace simd_ascii {
+
+// lo..hi is the range to convert ('a'..'z' for upper, 'A'..'Z' for lower).
+inline void case_convert_scalar(char* data, size_t n, char lo, char hi) {
+    for (size_t i = 0; i < n; i++) {
+        if (data[i] >= lo && data[i] <= hi) {
+            data[i] ^= 0x20;
+        }
+    }
+}
+
+inline void reverse_scalar(char* data, size_t n) {
+    std::reverse(data, data + n);
+}
+
+#ifdef SIMD_ASCII_X86
+
+// SSE2 is part of the x86_64 baseline, so no target attribute is needed.
+inline void case_convert_sse2(char* data, size_t n, char lo, char hi) {
+    const __m128i vlo = _mm_set1_epi8(lo - 1);
+    const __m128i vhi = _mm_set1_epi8(hi + 1);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(x, vlo),
+                                         _mm_cmpgt_epi8(vhi, x));
+        x = _mm_xor_si128(x, _mm_and_si128(in_range, flip));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), x);
+    }
+    case_convert_scalar(data + i, n - i, lo, hi);
+}
+
+__attribute__((target("avx2")))
+inline void case_convert_avx2(char* data, size_t n, char lo, char hi) {
+    const __m256i vlo = _mm256_set1_epi8(lo - 1);
+    const __m256i vhi = _mm256_set1_epi8(hi + 1);
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(x, vlo),
+                                            _mm256_cmpgt_epi8(vhi, x));
+        x = _mm256_xor_si256(x, _mm256_and_si256(in_range, flip));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), x);
+    }
+    case_convert_scalar(data + i, n - i, lo, hi);
+}
+
+// Swaps 16-byte blocks from both ends, byte-reversing each with pshufb.
+__attribute__((target("ssse3")))
+inline void reverse_ssse3(char* data, size_t n) {
+    const __m128i idx = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                     8, 9, 10, 11, 12, 13, 14, 15);
+    char* front = data;
+    char* back = data + n;
+    while (back - front >= 32) {
+        back -= 16;
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(front));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(back));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(front), _mm_shuffle_epi8(b, idx));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(back), _mm_shuffle_epi8(a, idx));
+        front += 16;
+    }
+    std::reverse(front, back);
+}
+
+inline bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+inline bool has_ssse3() {
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+}
+
+#endif  // SIMD_ASCII_X86
+
+inline void to_upper(char* data, size_t n) {
+#ifdef SIMD_ASCII_X86
+    if (has_avx2()) {
+        case_convert_avx2(data, n, 'a', 'z');
+    } else {
+        case_convert_sse2(data, n, 'a', 'z');
+    }
+#else
+    case_convert_scalar(data, n, 'a', 'z');
+#endif
+}
+
+inline void to_lower(char* data, size_t n) {
+#ifdef SIMD_ASCII_X86
+    if (has_avx2()) {
+        case_convert_avx2(data, n, 'A', 'Z');
+    } else {
+        case_convert_sse2(data, n, 'A', 'Z');
+    }
+#else
+    case_convert_scalar(data, n, 'A', 'Z');
+#endif
+}
+
+inline void reverse(char* data, size_t n) {
+#ifdef SIMD_ASCII_X86
+    if (has_ssse3()) {
+        reverse_ssse3(data, n);
+        return;
+    }
+#endif
+    reverse_scalar(data, n);
+}
+
+}  // namespace simd_ascii
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd_ascii.h"
+
+// Throughput microbenchmark for the string_ops kernels, so case-conversion
+// regressions are measurable instead of anecdotal:
+//
+//   ./string-ops-bench [buffer_mb] [iterations]
+//
+// Reports GB/s per kernel variant and cross-checks every variant against
+// the scalar reference on the same input.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double runGBps(void (*kernel)(char*, size_t, char, char),
+               std::string& buffer, int iterations, char lo, char hi) {
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        kernel(&buffer[0], buffer.size(), lo, hi);
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    double bytes = static_cast<double>(buffer.size()) * iterations;
+    return bytes / elapsed.count() / 1e9;
+}
+
+double runReverseGBps(void (*kernel)(char*, size_t),
+                      std::string& buffer, int iterations) {
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        kernel(&buffer[0], buffer.size());
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    double bytes = static_cast<double>(buffer.size()) * iterations;
+    return bytes / elapsed.count() / 1e9;
+}
+
+bool checkAgainstScalar(void (*kernel)(char*, size_t, char, char),
+                        const std::string& input, char lo, char hi) {
+    std::string expected = input;
+    std::string actual = input;
+    simd_ascii::case_convert_scalar(&expected[0], expected.size(), lo, hi);
+    kernel(&actual[0], actual.size(), lo, hi);
+    return expected == actual;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t buffer_mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::string buffer(buffer_mb * 1024 * 1024, '\0');
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> printable(0x20, 0x7e);
+    for (auto& c : buffer) {
+        c = static_cast<char>(printable(rng));
+    }
+
+    std::printf("string_ops bench: %zuMB buffer, %d iterations\n\n",
+                buffer_mb, iterations);
+
+    std::printf("upper  scalar: %7.2f GB/s\n",
+                runGBps(simd_ascii::case_convert_scalar, buffer, iterations, 'a', 'z'));
+#ifdef SIMD_ASCII_X86
+    if (!checkAgainstScalar(simd_ascii::case_convert_sse2, buffer, 'a', 'z')) {
+        std::fprintf(stderr, "FAIL: sse2 upper diverges from scalar\n");
+        return 1;
+    }
+    std::printf("upper  sse2:   %7.2f GB/s\n",
+                runGBps(simd_ascii::case_convert_sse2, buffer, iterations, 'a', 'z'));
+    if (simd_ascii::has_avx2()) {
+        if (!checkAgainstScalar(simd_ascii::case_convert_avx2, buffer, 'a', 'z')) {
+            std::fprintf(stderr, "FAIL: avx2 upper diverges from scalar\n");
+            return 1;
+        }
+        std::printf("upper  avx2:   %7.2f GB/s\n",
+                    runGBps(simd_ascii::case_convert_avx2, buffer, iterations, 'a', 'z'));
+    }
+#endif
+
+    std::printf("lower  scalar: %7.2f GB/s\n",
+                runGBps(simd_ascii::case_convert_scalar, buffer, iterations, 'A', 'Z'));
+#ifdef SIMD_ASCII_X86
+    std::printf("lower  sse2:   %7.2f GB/s\n",
+                runGBps(simd_ascii::case_convert_sse2, buffer, iterations, 'A', 'Z'));
+    if (simd_ascii::has_avx2()) {
+        std::printf("lower  avx2:   %7.2f GB/s\n",
+                    runGBps(simd_ascii::case_convert_avx2, buffer, iterations, 'A', 'Z'));
+    }
+#endif
+
+    std::printf("revers scalar: %7.2f GB/s\n",
+                runReverseGBps(simd_ascii::reverse_scalar, buffer, iterations));
+#ifdef SIMD_ASCII_X86
+    if (simd_ascii::has_ssse3()) {
+        std::string expected = buffer;
+        std::string actual = buffer;
+        simd_ascii::reverse_scalar(&expected[0], expected.size());
+        simd_ascii::reverse_ssse3(&actual[0], actual.size());
+        if (expected != actual) {
+            std::fprintf(stderr, "FAIL: ssse3 reverse diverges from scalar\n");
+            return 1;
+        }
+        std::printf("revers ssse3:  %7.2f GB/s\n",
+                    runReverseGBps(simd_ascii::reverse_ssse3, buffer, iterations));
+    }
+#endif
+
+    return 0;
+}
@@ -1,39 +1,87 @@
 #include "plugin.h"
-#include <algorithm>
-#include <cctype>
+#include "plugin_registry.h"
+#include "simd_ascii.h"
 #include <string>
 
-class StringOpsPlugin : public Plugin {
+// final so call sites holding the concrete type devirtualize execute().
+class StringOpsPlugin final : public Plugin {
 public:
     std::string get_name() const override {
         return "string_ops";
     }
 
     std::string get_description() const override {
-        return "String manipulation operations (upper, lower, reverse)";
+        return "String manipulation operations (upper, lower, reverse), "
+               "single or batch, SIMD-accelerated for ASCII";
     }
 
+    bool is_deterministic() const override { return true; }
+
     json execute(const json& input, ExecutionContext* context = nullptr) override {
-        std::string text = input.value("text", "");
         std::string operation = input.value("operation", "");
-        std::string result = text;
 
+        // Batch form: {"operation": ..., "items": ["a", "b", ...]}
+        // processes every string in one call instead of one hub
+        // round-trip per item. Large batches are the map step of a
+        // parallel-for over the dispatch pool; results land in an
+        // index-addressed vector so input order is preserved for free.
+        if (input.contains("items")) {
+            const json& items = input.at("items");
+            if (!items.is_array()) {
+                throw std::runtime_error("'items' must be an array of strings");
+            }
+            std::vector<json> results(items.size());
+            auto map_item = [&](size_t i) {
+                // Cooperative deadline check: once the caller stops
+                // listening, remaining items get an error slot instead
+                // of burning CPU on an answer nobody reads.
+                if (context && context->expired()) {
+                    results[i] = json{{"error", "deadline exceeded"}};
+                    return;
+                }
+                try {
+                    std::string text = items[i].get<std::string>();
+                    apply(operation, text);
+                    results[i] = std::move(text);
+                } catch (const std::exception& e) {
+                    results[i] = json{{"error", e.what()}};
+                }
+            };
+            // Below this size the fan-out overhead beats the work.
+            constexpr size_t kParallelThreshold = 32;
+            if (context && context->parallel_for &&
+                items.size() >= kParallelThreshold) {
+                context->parallel_for(items.size(), map_item);
+            } else {
+                for (size_t i = 0; i < items.size(); i++) {
+                    map_item(i);
+                }
+            }
+            return {{"results", json(std::move(results))}};
+        }
+
+        std::string text = input.value("text", "");
+        apply(operation, text);
+        return {{"result", std::move(text)}};
+    }
+
+private:
+    static void apply(const std::string& operation, std::string& text) {
         if (operation == "upper") {
-            std::transform(result.begin(), result.end(), result.begin(),
-                         [](unsigned char c) { return std::toupper(c); });
+            simd_ascii::to_upper(&text[0], text.size());
         } else if (operation == "lower") {
-            std::transform(result.begin(), result.end(), result.begin(),
-                         [](unsigned char c) { return std::tolower(c); });
+            simd_ascii::to_lower(&text[0], text.size());
         } else if (operation == "reverse") {
-            std::reverse(result.begin(), result.end());
+            simd_ascii::reverse(&text[0], text.size());
         } else {
             throw std::runtime_error("Unknown operation: " + operation);
         }
-
-        return {{"result", result}};
     }
 };
 
+REGISTER_PLUGIN(StringOpsPlugin, "string_ops");
+
+// Kept for callers that construct plugins directly (see all_plugins.h).
 PluginPtr create_string_ops_plugin() {
     return std::make_shared<StringOpsPlugin>();
 }
@@ -1,53 +1,309 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <csignal>
+#include <ctime>
+#include <random>
+#include <semaphore.h>
 #include <grpcpp/grpcpp.h>
 #include <nlohmann/json.hpp>
 #include "hub.grpc.pb.h"
+#include "async_logger.h"
+#include "cpu_affinity.h"
 #include "plugin_manager.h"
+#include "dispatch_pool.h"
+#include "message_arena.h"
+#include "shm_ring.h"
+#include "worker_calls.h"
+#include "worker_metrics.h"
+#include "write_batcher.h"
 
-// Forward declarations for plugin factory functions
-extern PluginPtr create_hello_cpp_plugin();
-extern PluginPtr create_string_ops_plugin();
+// worker_stats takes the manager pointer, so it can't self-register via
+// REGISTER_PLUGIN like the other builtins.
+extern PluginPtr create_worker_stats_plugin(PluginManager* manager);
 
-using json = nlohmann::json;
 using grpc::Channel;
 using grpc::ClientContext;
 using grpc::ClientReaderWriter;
 using grpc::Status;
 
-class CPPWorkerGRPC {
-private:
-    std::string worker_id_;
-    std::string hub_address_;
-    std::unique_ptr<hub::HubService::Stub> stub_;
-    std::shared_ptr<ClientReaderWriter<hub::Message, hub::Message>> stream_;
-    std::unique_ptr<ClientContext> context_;  // Must outlive the stream!
-    std::atomic<bool> running_;
-    PluginManager plugin_manager_;
+namespace {
 
-    void sendRegistration() {
-        std::cout << "[cpp-worker] 📝 Preparing registration message...\n";
-        
-        hub::Message msg;
-        msg.set_type(hub::MessageType::REGISTER);
-        msg.set_from(worker_id_);
-        msg.set_to("hub");
+// One request arena per dispatch thread. The dispatch layer installs it
+// (RequestArena::Scope) around processRequest, so every json node the
+// request builds is a pointer bump, and resets it wholesale once the
+// response is enqueued — by then the content has been flattened into the
+// hub::Message and nothing references arena memory.
+thread_local RequestArena request_arena;
+
+std::string base64Encode(const std::string& data);
+std::string base64Decode(const std::string& data);
+
+// Negotiated binary encodings for Message.content. JSON text stays the
+// default; a client that sets metadata content_encoding to msgpack or
+// cbor sends nlohmann binary payloads instead — ~3x smaller for
+// numeric-heavy params and decoded without text tokenization — and gets
+// its response back in the same encoding. Message.content is a proto3
+// string, so the binary bytes travel base64-wrapped (the same UTF-8
+// constraint the typed registration hit); even at 4/3 overhead the
+// payload stays well under the JSON text size.
+enum class ContentEncoding { Json, MsgPack, Cbor };
+
+ContentEncoding encodingFor(const hub::Message& msg) {
+    auto it = msg.metadata().find("content_encoding");
+    if (it == msg.metadata().end()) {
+        return ContentEncoding::Json;
+    }
+    if (it->second == "msgpack") {
+        return ContentEncoding::MsgPack;
+    }
+    if (it->second == "cbor") {
+        return ContentEncoding::Cbor;
+    }
+    return ContentEncoding::Json;
+}
+
+json decodeContent(ContentEncoding encoding, const std::string& content) {
+    std::string raw = base64Decode(content);
+    std::vector<uint8_t> bytes(raw.begin(), raw.end());
+    return encoding == ContentEncoding::MsgPack ? json::from_msgpack(bytes)
+                                                : json::from_cbor(bytes);
+}
+
+void setEncodedContent(hub::Message& response, ContentEncoding encoding,
+                       const json& envelope) {
+    std::vector<uint8_t> bytes = encoding == ContentEncoding::MsgPack
+                                     ? json::to_msgpack(envelope)
+                                     : json::to_cbor(envelope);
+    response.set_content(base64Encode(
+        std::string(bytes.begin(), bytes.end())));
+    (*response.mutable_metadata())["content_encoding"] =
+        encoding == ContentEncoding::MsgPack ? "msgpack" : "cbor";
+}
+
+// Executes one REQUEST message and fills the RESPONSE envelope into the
+// caller-provided message (which may come from a MessageArena pool).
+// Shared by the sync (CPPWorkerGRPC) and async (CPPWorkerAsync) workers
+// so dispatch semantics stay identical across both transports.
+void processRequest(const hub::Message& msg,
+                    const std::string& worker_id,
+                    PluginManager& plugin_manager,
+                    hub::Message& response,
+                    ExecutionContext* context = nullptr) {
+    auto request_start = std::chrono::steady_clock::now();
+    response.set_type(hub::MessageType::RESPONSE);
+    response.set_id(msg.id());
+    response.set_from(worker_id);
+    response.set_to(msg.from());
+
+    // Binary-encoded requests take their own path: decode params with
+    // from_msgpack/from_cbor, execute, and reply in the same encoding.
+    ContentEncoding encoding = encodingFor(msg);
+    if (encoding != ContentEncoding::Json) {
+        try {
+            json content = decodeContent(encoding, msg.content());
+            std::string capability;
+            auto meta_it = msg.metadata().find("capability");
+            if (meta_it != msg.metadata().end()) {
+                capability = meta_it->second;
+            } else if (content.contains("capability")) {
+                capability = content["capability"];
+            }
+            json params;
+            if (content.contains("params")) {
+                params = std::move(content["params"]);
+            } else {
+                params = std::move(content);
+            }
+
+            WorkerMetrics::instance().parse.record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - request_start).count());
+            LOG_DEBUG("[cpp-worker] Request: " << capability
+                      << " from " << msg.from());
+
+            json result =
+                plugin_manager.execute(capability, std::move(params), context);
+            setEncodedContent(response, encoding,
+                              json{{"success", true},
+                                   {"result", std::move(result)}});
+        } catch (const std::exception& e) {
+            LOG_WARN("[cpp-worker] Error handling request: " << e.what());
+            setEncodedContent(response, encoding,
+                              json{{"success", false}, {"error", e.what()}});
+        }
+        WorkerMetrics::instance().total.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - request_start).count());
+        return;
+    }
+
+    try {
+        std::string serialized;
+        // Fast path: the hub puts the capability in metadata, so routing
+        // needs a plain map lookup — no JSON involved at all.
+        std::string capability;
+        auto meta_it = msg.metadata().find("capability");
+        if (meta_it != msg.metadata().end()) {
+            capability = meta_it->second;
+        }
+
+        if (!capability.empty()) {
+            LOG_DEBUG("[cpp-worker] Request: " << capability
+                      << " from " << msg.from());
+
+            // The raw content goes straight to the plugin: raw-capable
+            // plugins parse it on demand themselves, legacy plugins get
+            // one materializing parse inside Plugin::execute_raw. The
+            // result comes back already dumped — on a result-cache hit
+            // the cached string is reused without any JSON work.
+            plugin_manager.execute_raw_serialized(capability, msg.content(),
+                                                  context, serialized);
+        } else {
+            // Fallback for messages without metadata: older clients name
+            // the capability inside the content JSON.
+            auto content = json::parse(msg.content());
+            if (content.contains("capability")) {
+                capability = content["capability"];
+            }
+            json params;
+            if (content.contains("params")) {
+                params = std::move(content["params"]);
+            } else {
+                params = std::move(content);
+            }
+
+            WorkerMetrics::instance().parse.record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - request_start).count());
+
+            LOG_DEBUG("[cpp-worker] Request: " << capability
+                      << " from " << msg.from());
+
+            serialized = plugin_manager
+                             .execute(capability, std::move(params), context)
+                             .dump();
+        }
+
+        // Compose the envelope by concatenation: serialized is already a
+        // JSON value, so the response never rebuilds a DOM around it.
+        std::string content;
+        content.reserve(serialized.size() + 24);
+        content.append("{\"success\":true,\"result\":");
+        content.append(serialized);
+        content.push_back('}');
+        response.set_content(std::move(content));
+
+    } catch (const std::exception& e) {
+        LOG_WARN("[cpp-worker] Error handling request: " << e.what());
+        json error_data = {
+            {"success", false},
+            {"error", e.what()}
+        };
+        response.set_content(error_data.dump());
+    }
+
+    WorkerMetrics::instance().total.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - request_start).count());
+}
+
+// Message.content is a proto3 string and must stay valid UTF-8, so the
+// serialized WorkerRegistration travels base64-encoded. Encoding a few
+// KB once per (re)connect is noise next to the JSON build it replaces.
+std::string base64Encode(const std::string& data) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        uint32_t n = (static_cast<unsigned char>(data[i]) << 16) |
+                     (static_cast<unsigned char>(data[i + 1]) << 8) |
+                     static_cast<unsigned char>(data[i + 2]);
+        out.push_back(alphabet[(n >> 18) & 0x3f]);
+        out.push_back(alphabet[(n >> 12) & 0x3f]);
+        out.push_back(alphabet[(n >> 6) & 0x3f]);
+        out.push_back(alphabet[n & 0x3f]);
+    }
+    if (i < data.size()) {
+        uint32_t n = static_cast<unsigned char>(data[i]) << 16;
+        if (i + 1 < data.size()) {
+            n |= static_cast<unsigned char>(data[i + 1]) << 8;
+        }
+        out.push_back(alphabet[(n >> 18) & 0x3f]);
+        out.push_back(alphabet[(n >> 12) & 0x3f]);
+        out.push_back(i + 1 < data.size() ? alphabet[(n >> 6) & 0x3f] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+std::string base64Decode(const std::string& data) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+    std::string out;
+    out.reserve(data.size() / 4 * 3);
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : data) {
+        int v = value(c);
+        if (v < 0) {
+            if (c == '=') {
+                break;
+            }
+            throw std::runtime_error("invalid base64 in content");
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buffer >> bits) & 0xff));
+        }
+    }
+    return out;
+}
+
+// Opt-in flag: WORKER_PROTO_REGISTRATION=1 sends the typed
+// WorkerRegistration proto instead of the JSON blob. Only set it against
+// a hub that decodes registration_format=protobuf-base64 — this repo's
+// Go hub does json.Unmarshal on Message.content and would register the
+// worker with zero capabilities otherwise.
+bool protoRegistrationFromEnv() {
+    const char* env = std::getenv("WORKER_PROTO_REGISTRATION");
+    return env && std::string(env) == "1";
+}
 
-        std::cout << "[cpp-worker] 📝 Building capabilities JSON...\n";
+// Builds the REGISTER message advertising every plugin's capability.
+// Shared by both workers so re-registration stays in one place. The
+// default is the JSON blob the hub parses today; the typed
+// WorkerRegistration proto (base64 in content, metadata
+// registration_format=protobuf-base64, skipping the nlohmann build/dump
+// here and the re-parse hub-side) waits behind
+// WORKER_PROTO_REGISTRATION=1 until the hub learns to decode it.
+hub::Message buildRegistration(const std::string& worker_id,
+                               PluginManager& plugin_manager) {
+    hub::Message msg;
+    msg.set_type(hub::MessageType::REGISTER);
+    msg.set_from(worker_id);
+    msg.set_to("hub");
+
+    if (!protoRegistrationFromEnv()) {
         json capabilities = json::array();
-        
-        // Get all plugins and create capabilities
-        std::cout << "[cpp-worker] 📝 Getting plugins...\n";
-        auto all_plugins = plugin_manager_.getAllPlugins();
-        std::cout << "[cpp-worker] 📝 Found " << all_plugins.size() << " plugins\n";
-        
-        for (const auto& plugin : all_plugins) {
-            std::cout << "[cpp-worker] 📝 Processing plugin: " << plugin->getName() << "\n";
+        for (const auto& plugin : plugin_manager.getAllPlugins()) {
             json cap = {
                 {"name", plugin->getName()},
                 {"description", plugin->getDescription()},
@@ -56,143 +312,684 @@ private:
                 {"optional_params", plugin->getOptionalParams()}
             };
             capabilities.push_back(cap);
-            std::cout << "[cpp-worker] 📝 Plugin capability added\n";
         }
 
-        std::cout << "[cpp-worker] 📝 Creating registration data JSON...\n";
         json reg_data = {
-            {"worker_id", worker_id_},
+            {"worker_id", worker_id},
             {"worker_type", "cpp"},
             {"capabilities", capabilities},
+            {"content_encodings", "json,msgpack,cbor"},
             {"status", "active"}
         };
 
-        std::cout << "[cpp-worker] 📝 Converting JSON to string...\n";
-        std::string json_str = reg_data.dump();
-        std::cout << "[cpp-worker] 📝 JSON string length: " << json_str.length() << "\n";
-        
-        msg.set_content(json_str);
-        
+        msg.set_content(reg_data.dump());
+        return msg;
+    }
+
+    hub::WorkerRegistration registration;
+    registration.set_worker_id(worker_id);
+    registration.set_worker_type("cpp");
+    (*registration.mutable_metadata())["status"] = "active";
+    // Encodings this worker accepts for Message.content; clients pick
+    // one via metadata content_encoding on each request.
+    (*registration.mutable_metadata())["content_encodings"] =
+        "json,msgpack,cbor";
+    for (const auto& plugin : plugin_manager.getAllPlugins()) {
+        hub::ServiceCapability* cap = registration.add_capabilities();
+        cap->set_name(plugin->getName());
+        cap->set_description(plugin->getDescription());
+        json input_schema = {
+            {"type", "object"},
+            {"required", plugin->getRequiredParams()},
+            {"optional", plugin->getOptionalParams()}
+        };
+        cap->set_input_schema(input_schema.dump());
+    }
+
+    msg.set_content(base64Encode(registration.SerializeAsString()));
+    (*msg.mutable_metadata())["registration_format"] = "protobuf-base64";
+    return msg;
+}
+
+// Heartbeat cadence (HEARTBEAT_INTERVAL_S, 0 disables). The default is
+// deliberately tighter than TCP keepalive: a hung worker should be off
+// the hub's routing table in seconds, not minutes.
+std::chrono::seconds heartbeatIntervalFromEnv() {
+    const char* env = std::getenv("HEARTBEAT_INTERVAL_S");
+    if (env) {
+        long seconds = std::atol(env);
+        if (seconds >= 0) {
+            return std::chrono::seconds(seconds);
+        }
+    }
+    return std::chrono::seconds(10);
+}
+
+std::string isoTimestamp() {
+    std::time_t now = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now());
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%FT%TZ", std::gmtime(&now));
+    return buf;
+}
+
+// Liveness beat over the existing stream, same DIRECT shape the other
+// workers send. queue_depth/in_flight ride in metadata so the hub's
+// scheduler can route least-loaded across the fleet instead of just
+// checking for a pulse.
+void buildHeartbeat(const std::string& worker_id, size_t queue_depth,
+                    size_t in_flight, hub::Message& beat) {
+    beat.set_type(hub::MessageType::DIRECT);
+    beat.set_from(worker_id);
+    beat.set_to("hub");
+    beat.set_timestamp(isoTimestamp());
+    auto& meta = *beat.mutable_metadata();
+    meta["event"] = "heartbeat";
+    meta["queue_depth"] = std::to_string(queue_depth);
+    meta["in_flight"] = std::to_string(in_flight);
+}
+
+// Identifying first frame of an extra Connect() stream. The hub keys
+// every stream by the From of its first message, so each extra stream
+// announces itself under a synthetic per-stream id
+// ("<worker_id>#<index>"): a distinct connection-table entry that never
+// overwrites the primary's routing entry, and whose removal when the
+// stream ends deregisters nothing — unregistering an unknown worker id
+// is a no-op on the hub. Responses still carry the worker's own From
+// and reach their caller the same way from any stream.
+hub::Message buildStreamHello(const std::string& worker_id, size_t index) {
+    hub::Message hello;
+    hello.set_type(hub::MessageType::DIRECT);
+    hello.set_from(worker_id + "#" + std::to_string(index));
+    hello.set_to("hub");
+    hello.set_timestamp(isoTimestamp());
+    auto& meta = *hello.mutable_metadata();
+    meta["event"] = "stream-attach";
+    meta["worker_id"] = worker_id;
+    meta["stream_index"] = std::to_string(index);
+    return hello;
+}
+
+// Priority lane for a request, from Message.metadata["priority"]. Only
+// "high" is distinguished; anything else rides the normal lane.
+DispatchPool::Lane laneFor(const hub::Message& msg) {
+    auto it = msg.metadata().find("priority");
+    if (it != msg.metadata().end() && it->second == "high") {
+        return DispatchPool::Lane::High;
+    }
+    return DispatchPool::Lane::Normal;
+}
+
+// Absolute deadline for a request, from Message.metadata["deadline_ms"]
+// relative to now — call it at admission so queue wait counts against
+// the budget. Returns the default time_point when no deadline is set.
+std::chrono::steady_clock::time_point deadlineFor(const hub::Message& msg) {
+    auto it = msg.metadata().find("deadline_ms");
+    if (it == msg.metadata().end()) {
+        return {};
+    }
+    long ms = std::atol(it->second.c_str());
+    if (ms <= 0) {
+        return {};
+    }
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+}
+
+// True once a deadline from deadlineFor() has passed (the default
+// time_point never expires).
+bool expiredAt(std::chrono::steady_clock::time_point deadline) {
+    return deadline != std::chrono::steady_clock::time_point{} &&
+           std::chrono::steady_clock::now() >= deadline;
+}
+
+// How long a shed client should wait before retrying (SHED_RETRY_AFTER_MS).
+int shedRetryAfterMs() {
+    static int cached = [] {
+        const char* env = std::getenv("SHED_RETRY_AFTER_MS");
+        if (env) {
+            int ms = std::atoi(env);
+            if (ms > 0) {
+                return ms;
+            }
+        }
+        return 100;
+    }();
+    return cached;
+}
+
+// Early-rejection RESPONSE sent when the dispatch queue is full. Cheap
+// to build on the reader thread; the retry_after_ms hint lets the hub
+// back off instead of hammering an already saturated worker.
+void buildOverloadResponse(const hub::Message& msg, const std::string& worker_id,
+                           size_t queue_depth, hub::Message& response) {
+    response.set_type(hub::MessageType::RESPONSE);
+    response.set_id(msg.id());
+    response.set_from(worker_id);
+    response.set_to(msg.from());
+    json error_data = {
+        {"success", false},
+        {"error", "worker overloaded"},
+        {"retry_after_ms", shedRetryAfterMs()},
+        {"queue_depth", queue_depth}
+    };
+    response.set_content(error_data.dump());
+}
+
+}  // namespace
+
+class CPPWorkerGRPC {
+private:
+    std::string worker_id_;
+    std::string hub_address_;
+    // Created (and warmed) in the constructor; gRPC channels manage
+    // their own reconnects, so every connect() attempt reuses it. The
+    // stub lives as long as the channel: dispatch threads call
+    // DownloadFile/UploadFile through it mid-request, and a request may
+    // span a reconnect, so it is created once and never reassigned.
+    std::shared_ptr<grpc::Channel> channel_;
+    std::unique_ptr<hub::HubService::Stub> stub_;
+    // Co-located fast path (HUB_ADDRESS=shm:/<name>): messages ride a
+    // shared-memory ring pair instead of the stream. Null on the
+    // default gRPC path.
+    std::unique_ptr<shm_ring::Conduit> shm_;
+    std::shared_ptr<ClientReaderWriter<hub::Message, hub::Message>> stream_;
+    std::unique_ptr<ClientContext> context_;  // Must outlive the stream!
+    // Additional Connect() streams (WORKER_STREAMS > 1). One HTTP/2
+    // stream has a single flow-control window, and at high message rates
+    // that window — not the NIC — caps per-worker wire throughput. Extra
+    // streams share the channel but each gets its own ClientContext (a
+    // context serves exactly one call) and its own blocking reader;
+    // outgoing responses spread across all streams keyed by request id,
+    // so every message of one exchange keeps its ordering. Registration
+    // goes out once, on the primary stream; each extra stream opens with
+    // a stream-attach hello (see buildStreamHello) so the hub keys it
+    // under its own per-stream id instead of clobbering the primary's.
+    struct ExtraStream {
+        std::unique_ptr<ClientContext> context;  // must outlive the stream
+        std::shared_ptr<ClientReaderWriter<hub::Message, hub::Message>> stream;
+        std::mutex write_mutex;
+        std::thread reader;
+        bool open = false;  // guarded by write_mutex
+    };
+    std::vector<std::unique_ptr<ExtraStream>> extra_streams_;
+    // Routing reads this instead of extra_streams_.size() so teardown can
+    // redirect in-flight flushes to the primary stream before Finish().
+    std::atomic<size_t> active_extra_streams_{0};
+    std::atomic<bool> running_;
+    std::atomic<bool> stopped_{false};  // process-level stop, ends supervise()
+    std::atomic<bool> draining_{false};
+    std::atomic<bool> writes_done_{false};  // WritesDone may only fire once
+    PluginManager plugin_manager_;
+    DispatchPool dispatch_pool_;
+    MessageArena message_arena_;
+    WriteBatcher write_batcher_;
+    WorkerCallRegistry worker_calls_;
+    std::atomic<uint64_t> call_seq_{0};
+    std::mutex write_mutex_;  // ClientReaderWriter allows only one concurrent writer
+    std::atomic<size_t> in_flight_{0};  // admitted but not yet answered
+    // Shared by every ExecutionContext; flipped when the drain deadline
+    // abandons in-flight work so cooperating plugins stop early.
+    std::shared_ptr<std::atomic<bool>> cancel_requests_ =
+        std::make_shared<std::atomic<bool>>(false);
+    std::thread heartbeat_thread_;
+    std::mutex heartbeat_mutex_;
+    std::condition_variable heartbeat_cv_;
+    bool heartbeat_stop_ = false;
+
+    // Configurable via WORKER_THREADS; 0 falls back to hardware_concurrency
+    static size_t threadCountFromEnv() {
+        const char* env = std::getenv("WORKER_THREADS");
+        if (env) {
+            int count = std::atoi(env);
+            if (count > 0) {
+                return static_cast<size_t>(count);
+            }
+        }
+        return 0;
+    }
+
+    // Admission-control depth for the dispatch queue (DISPATCH_QUEUE_DEPTH).
+    static size_t queueDepthFromEnv() {
+        const char* env = std::getenv("DISPATCH_QUEUE_DEPTH");
+        if (env) {
+            long depth = std::atol(env);
+            if (depth > 0) {
+                return static_cast<size_t>(depth);
+            }
+        }
+        return 1024;
+    }
+
+    // Batching amortizes the per-write flush on the gRPC stream; an shm
+    // ring send is just a memcpy with nothing to cork, so there the
+    // window defaults to zero (immediate flush) unless the operator set
+    // one explicitly.
+    static std::chrono::microseconds batchWindowFor(const std::string& address) {
+        const char* env = std::getenv("WRITE_BATCH_WINDOW_US");
+        if (env) {
+            long us = std::atol(env);
+            if (us >= 0) {
+                return std::chrono::microseconds(us);
+            }
+        }
+        return shm_ring::is_shm_address(address)
+                   ? std::chrono::microseconds(0)
+                   : std::chrono::microseconds(1000);
+    }
+
+    // Parallel Connect() streams per worker (WORKER_STREAMS, default 1).
+    // Throughput scales roughly linearly up to about 4 streams; beyond
+    // that the channel's TCP connection is the bottleneck. Only the gRPC
+    // path shards — the shm conduit is one ring pair.
+    static size_t streamCountFromEnv() {
+        const char* env = std::getenv("WORKER_STREAMS");
+        if (env) {
+            int n = std::atoi(env);
+            if (n > 0) {
+                return static_cast<size_t>(std::min(n, 8));
+            }
+        }
+        return 1;
+    }
+
+    static size_t batchSizeFromEnv() {
+        const char* env = std::getenv("WRITE_BATCH_MAX");
+        if (env) {
+            int n = std::atoi(env);
+            if (n > 0) {
+                return static_cast<size_t>(n);
+            }
+        }
+        return 16;
+    }
+
+    // All stream writes funnel through here so the dispatch pool threads
+    // never race on the single gRPC writer. Control messages (registration,
+    // errors) use this directly; responses go through write_batcher_.
+    bool writeMessage(const hub::Message& msg) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        // The mutex also provides the shm ring's single-producer side.
+        if (shm_) {
+            return shm_->send(msg);
+        }
+        // Between closeWrites() and the next session the stream is not
+        // writable; stragglers from the dead session fail fast instead
+        // of writing after WritesDone()/Finish().
+        if (!stream_ || writes_done_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        return stream_->Write(msg);
+    }
+
+    // Stream carrying this message: everything with the same id stays on
+    // one stream, so the messages of one exchange keep their ordering
+    // while distinct requests spread across every flow-control window.
+    size_t streamIndexFor(const hub::Message& msg) const {
+        size_t extras = active_extra_streams_.load(std::memory_order_relaxed);
+        if (extras == 0) {
+            return 0;
+        }
+        return std::hash<std::string>{}(msg.id()) % (extras + 1);
+    }
+
+    // Writes one batched message; non-final writes carry buffer_hint so
+    // gRPC coalesces them into the final flush of the batch.
+    bool writeBatched(const hub::Message& msg, bool last_in_batch) {
+        auto write_start = std::chrono::steady_clock::now();
+        bool ok = writeBatchedImpl(msg, last_in_batch);
+        WorkerMetrics::instance().write.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - write_start).count());
+        return ok;
+    }
+
+    bool writeBatchedImpl(const hub::Message& msg, bool last_in_batch) {
+        if (shm_) {
+            // A ring write is already just a memcpy; there is no
+            // transport flush to cork, so batching hints don't apply.
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            return shm_->send(msg);
+        }
+        size_t index = streamIndexFor(msg);
+        if (index > 0) {
+            ExtraStream& extra = *extra_streams_[index - 1];
+            std::unique_lock<std::mutex> lock(extra.write_mutex);
+            if (extra.open) {
+                return extra.stream->Write(msg);
+            }
+            // Torn down mid-flush; stragglers ride the primary stream.
+        }
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        // Same fail-fast as writeMessage: never write a closed or
+        // swapped-out stream.
+        if (!stream_ || writes_done_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        grpc::WriteOptions options;
+        // Corking across a batch only pays off when every write lands on
+        // the same stream; with parallel streams each write flushes.
+        if (!last_in_batch &&
+            active_extra_streams_.load(std::memory_order_relaxed) == 0) {
+            options.set_buffer_hint();
+        }
+        return stream_->Write(msg, options);
+    }
+
+    void sendRegistration() {
+        std::cout << "[cpp-worker] 📝 Preparing registration message...\n";
+        hub::Message msg = buildRegistration(worker_id_, plugin_manager_);
+
         std::cout << "[cpp-worker] 📤 Sending registration...\n";
-        if (stream_->Write(msg)) {
-            std::cout << "[cpp-worker] 📤 Sent registration with " 
-                      << capabilities.size() << " capabilities\n";
+        if (writeMessage(msg)) {
+            std::cout << "[cpp-worker] 📤 Sent registration with "
+                      << plugin_manager_.plugin_count() << " capabilities\n";
         } else {
             std::cerr << "[cpp-worker] ❌ Failed to send registration\n";
         }
     }
 
-    void handleRequest(const hub::Message& msg) {
-        try {
-            std::string request_id = msg.id();
-            std::string original_sender = msg.from();
-            
-            // Parse request content
-            auto content = json::parse(msg.content());
-            std::string capability;
-            json params;
-            
-            // Extract capability from metadata (protobuf Map -> JSON)
-            if (!msg.metadata().empty()) {
-                json metadata = json::object();
-                for (const auto& pair : msg.metadata()) {
-                    metadata[pair.first] = pair.second;
+    static constexpr size_t kFileChunkSize = 64 * 1024;
+
+    // Streams the request's payload down in 64KB chunks. Small payloads
+    // land in one preallocated buffer, large ones in a memory-mapped temp
+    // file (see FilePayload), instead of arriving base64-encoded in
+    // Message.content.
+    bool downloadFile(const std::string& file_id, ExecutionContext& ctx) {
+        if (!stub_) {
+            // File streaming stays on gRPC; the shm conduit only carries
+            // hub::Message frames.
+            std::cerr << "[cpp-worker] ❌ DownloadFile needs a gRPC hub "
+                         "connection\n";
+            return false;
+        }
+        ClientContext context;
+        hub::FileDownloadRequest request;
+        request.set_file_id(file_id);
+        request.set_chunk_size(kFileChunkSize);
+
+        auto reader = stub_->DownloadFile(&context, request);
+        auto payload = std::make_shared<FilePayload>();
+        payload->file_id = file_id;
+
+        hub::FileChunk chunk;
+        bool first = true;
+        while (reader->Read(&chunk)) {
+            if (first) {
+                payload->filename = chunk.filename();
+                payload->content_type = chunk.content_type();
+                if (!payload->reserve(chunk.total_size())) {
+                    std::cerr << "[cpp-worker] ❌ Failed to reserve payload storage for "
+                              << file_id << "\n";
+                    return false;
                 }
-                capability = metadata.value("capability", "");
+                first = false;
             }
-            
-            // Fallback to content fields
-            if (capability.empty() && content.contains("capability")) {
-                capability = content["capability"];
+            if (!payload->append(chunk.data().data(), chunk.data().size())) {
+                std::cerr << "[cpp-worker] ❌ Payload overflow for " << file_id << "\n";
+                return false;
             }
-            
-            if (content.contains("params")) {
-                params = content["params"];
-            } else {
-                params = content;
+            if (chunk.is_last()) {
+                break;
             }
+        }
 
-            std::cout << "[cpp-worker] 📨 Request: " << capability 
-                      << " from " << original_sender << "\n";
+        Status status = reader->Finish();
+        if (!status.ok()) {
+            std::cerr << "[cpp-worker] ❌ DownloadFile failed for " << file_id
+                      << ": " << status.error_message() << "\n";
+            return false;
+        }
 
-            // Execute plugin
-            std::string result = plugin_manager_.execute(capability, params.dump());
-            
-            // Send response
-            sendResponse(request_id, original_sender, result);
-            
+        ctx.file = std::move(payload);
+        return true;
+    }
+
+    // Streams data up to the hub, returning the assigned file_id so a
+    // plugin can reference large results by file instead of inlining them.
+    std::string uploadFile(const std::string& data,
+                           const std::string& filename,
+                           const std::string& content_type) {
+        if (!stub_) {
+            std::cerr << "[cpp-worker] ❌ UploadFile needs a gRPC hub "
+                         "connection\n";
+            return "";
+        }
+        ClientContext context;
+        hub::FileUploadResponse upload_response;
+        auto writer = stub_->UploadFile(&context, &upload_response);
+
+        for (size_t offset = 0; offset < data.size(); offset += kFileChunkSize) {
+            size_t len = std::min(kFileChunkSize, data.size() - offset);
+            hub::FileChunk chunk;
+            chunk.set_data(data.data() + offset, len);
+            chunk.set_offset(static_cast<int64_t>(offset));
+            chunk.set_total_size(static_cast<int64_t>(data.size()));
+            chunk.set_filename(filename);
+            chunk.set_content_type(content_type);
+            chunk.set_is_last(offset + len >= data.size());
+            if (!writer->Write(chunk)) {
+                break;
+            }
+        }
+
+        writer->WritesDone();
+        Status status = writer->Finish();
+        if (!status.ok() || upload_response.status() != "success") {
+            std::cerr << "[cpp-worker] ❌ UploadFile failed: "
+                      << (status.ok() ? upload_response.error() : status.error_message())
+                      << "\n";
+            return "";
+        }
+        return upload_response.file_id();
+    }
+
+    // Sends a WORKER_CALL through the hub, correlated by a generated call
+    // id; the stream reader resolves the future when the RESPONSE lands.
+    std::future<json> callWorker(const std::string& target_worker,
+                                 const std::string& capability,
+                                 json params,
+                                 std::chrono::milliseconds deadline) {
+        std::string call_id = worker_id_ + "-call-" +
+            std::to_string(call_seq_.fetch_add(1, std::memory_order_relaxed));
+        std::future<json> future = worker_calls_.add(call_id, deadline);
+
+        hub::Message msg;
+        msg.set_type(hub::MessageType::WORKER_CALL);
+        msg.set_id(call_id);
+        msg.set_request_id(call_id);
+        msg.set_from(worker_id_);
+        msg.set_to(target_worker);
+        msg.set_content(params.dump());
+        (*msg.mutable_metadata())["capability"] = capability;
+        (*msg.mutable_metadata())["deadline_ms"] = std::to_string(deadline.count());
+
+        // Calls bypass the batcher: downstream latency sits on the
+        // critical path of the calling plugin.
+        if (!writeMessage(msg)) {
+            worker_calls_.fail(call_id, "failed to send worker call");
+        }
+        return future;
+    }
+
+    // Completes the pending worker-to-worker call matching this RESPONSE.
+    void handleCallResponse(const hub::Message& msg) {
+        try {
+            json content = json::parse(msg.content());
+            if (content.value("success", false)) {
+                json result = content.contains("result")
+                                  ? std::move(content["result"])
+                                  : json::object();
+                worker_calls_.complete(msg.id(), std::move(result));
+            } else {
+                worker_calls_.fail(msg.id(),
+                                   content.value("error", "worker call failed"));
+            }
         } catch (const std::exception& e) {
-            std::cerr << "[cpp-worker] ❌ Error handling request: " << e.what() << "\n";
-            sendError(msg.id(), msg.from(), e.what());
+            worker_calls_.fail(msg.id(), e.what());
         }
     }
 
-    void sendResponse(const std::string& request_id, 
-                     const std::string& to, 
-                     const std::string& result) {
-        hub::Message response;
-        response.set_type(hub::MessageType::RESPONSE);
-        response.set_id(request_id);
-        response.set_from(worker_id_);
-        response.set_to(to);
-        
-        json response_data = {
-            {"success", true},
-            {"result", json::parse(result)}
+    void handleRequest(const hub::Message& msg,
+                       std::chrono::steady_clock::time_point deadline = {}) {
+        ExecutionContext ctx;
+        ctx.worker_id = worker_id_;
+        ctx.deadline = deadline;
+        ctx.cancelled = cancel_requests_;
+        ctx.arena = &request_arena;
+        ctx.call_worker = [this](const std::string& target_worker,
+                                 const std::string& capability,
+                                 json params,
+                                 std::chrono::milliseconds deadline) {
+            return callWorker(target_worker, capability, std::move(params), deadline);
         };
-        
-        response.set_content(response_data.dump());
-        
-        if (stream_->Write(response)) {
-            std::cout << "[cpp-worker] ✅ Sent response to " << to << "\n";
-        } else {
-            std::cerr << "[cpp-worker] ❌ Failed to send response\n";
+        ctx.upload_file = [this](const std::string& data,
+                                 const std::string& filename,
+                                 const std::string& content_type) {
+            return uploadFile(data, filename, content_type);
+        };
+        ctx.parallel_for = [this](size_t count,
+                                  const std::function<void(size_t)>& body) {
+            dispatch_pool_.parallel_for(count, body);
+        };
+
+        // Large payloads arrive by reference: stream them down before the
+        // plugin runs rather than carrying base64 inside content.
+        if (!msg.file_id().empty() && !downloadFile(msg.file_id(), ctx)) {
+            hub::Message error_response;
+            error_response.set_type(hub::MessageType::RESPONSE);
+            error_response.set_id(msg.id());
+            error_response.set_from(worker_id_);
+            error_response.set_to(msg.from());
+            json error_data = {
+                {"success", false},
+                {"error", "Failed to download file payload: " + msg.file_id()}
+            };
+            error_response.set_content(error_data.dump());
+            writeMessage(error_response);
+            return;
+        }
+
+        hub::Message* response = message_arena_.acquire();
+        {
+            RequestArena::Scope scope(ctx.arena);
+            processRequest(msg, worker_id_, plugin_manager_, *response, &ctx);
         }
+
+        LOG_DEBUG("[cpp-worker] Queued response to " << response->to());
+        write_batcher_.enqueue(response);
+        ctx.arena->reset();
     }
 
-    void sendError(const std::string& request_id, 
-                  const std::string& to, 
-                  const std::string& error) {
-        hub::Message response;
-        response.set_type(hub::MessageType::RESPONSE);
-        response.set_id(request_id);
-        response.set_from(worker_id_);
-        response.set_to(to);
-        
-        json error_data = {
-            {"success", false},
-            {"error", error}
-        };
-        
-        response.set_content(error_data.dump());
-        stream_->Write(response);
+    bool readNext(hub::Message* msg) {
+        return shm_ ? shm_->recv(*msg, &running_) : stream_->Read(msg);
     }
 
-    void receiveLoop() {
-        hub::Message msg;
-        while (running_ && stream_->Read(&msg)) {
-            if (msg.type() == hub::MessageType::REQUEST) {
-                handleRequest(msg);
+    // One blocking read-dispatch loop; the primary stream runs it on the
+    // supervisor thread, each extra stream on its own reader thread.
+    void receiveLoop(const std::function<bool(hub::Message*)>& read_next) {
+        // Requests are read into pooled arena messages, so neither the
+        // Read() nor the hand-off to the pool copies the message.
+        hub::Message* msg = message_arena_.acquire();
+        while (running_ && read_next(msg)) {
+            if (msg->type() == hub::MessageType::REQUEST) {
+                // Hand off to the pool so a slow plugin doesn't stall
+                // the stream. Admission is bounded: when the lane is
+                // full the request is shed right here with a retry hint
+                // rather than queueing toward OOM.
+                in_flight_.fetch_add(1, std::memory_order_relaxed);
+                auto deadline = deadlineFor(*msg);
+                bool admitted = dispatch_pool_.try_submit(
+                    [this, msg, deadline] {
+                        // Dead on arrival: the caller stopped waiting
+                        // while this sat in the queue, so executing the
+                        // plugin would only burn CPU during the exact
+                        // overload that queued it.
+                        if (expiredAt(deadline)) {
+                            WorkerMetrics::instance().dropped_expired
+                                .fetch_add(1, std::memory_order_relaxed);
+                            LOG_DEBUG("[cpp-worker] Dropping expired request "
+                                      << msg->id());
+                        } else {
+                            handleRequest(*msg, deadline);
+                        }
+                        message_arena_.release(msg);
+                        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                    },
+                    laneFor(*msg));
+                if (admitted) {
+                    msg = message_arena_.acquire();
+                } else {
+                    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                    size_t depth = dispatch_pool_.queue_depth();
+                    LOG_WARN("[cpp-worker] Shedding request " << msg->id()
+                             << " (queue depth " << depth << ")");
+                    hub::Message* rejection = message_arena_.acquire();
+                    buildOverloadResponse(*msg, worker_id_, depth, *rejection);
+                    write_batcher_.enqueue(rejection);
+                }
+            } else if (msg->type() == hub::MessageType::RESPONSE) {
+                // Replies to our own worker-to-worker calls.
+                handleCallResponse(*msg);
             }
         }
+        message_arena_.release(msg);
     }
 
 public:
     CPPWorkerGRPC(const std::string& worker_id, const std::string& hub_address)
-        : worker_id_(worker_id), hub_address_(hub_address), running_(false) {
-        
+        : worker_id_(worker_id), hub_address_(hub_address), running_(false),
+          dispatch_pool_(threadCountFromEnv(), queueDepthFromEnv()),
+          write_batcher_([this](const hub::Message& msg, bool last_in_batch) {
+                             return writeBatched(msg, last_in_batch);
+                         },
+                         batchWindowFor(hub_address), batchSizeFromEnv(),
+                         [this](hub::Message* msg) { message_arena_.release(msg); }) {
+
         std::cout << "[cpp-worker] 🔵 Initializing C++ Worker...\n";
         std::cout << "[cpp-worker] Worker ID: " << worker_id << "\n";
         std::cout << "[cpp-worker] Hub Address: " << hub_address << "\n";
-        
+        std::cout << "[cpp-worker] Dispatch threads: " << dispatch_pool_.thread_count() << "\n";
+
+        // Topology from the operator: WORKER_CPUSET partitions the
+        // dispatch threads (e.g. the NIC node's CPUs on a dual-socket
+        // box), WRITER_CPUSET places the batch flusher next to them.
+        // The reader is pinned in supervise() via READER_CPUSET.
+        dispatch_pool_.set_cpuset(cpu_affinity::cpuset_from_env("WORKER_CPUSET"));
+        write_batcher_.set_cpuset(cpu_affinity::cpuset_from_env("WRITER_CPUSET"));
+
+        // Kick the channel handshake now so TCP/HTTP2 setup runs
+        // concurrently with the plugin construction below — GetState(true)
+        // requests the connect attempt without waiting for it, and
+        // connect() picks up the already-warm channel. Shared-memory
+        // addresses have no channel; connect() attaches the conduit.
+        if (!shm_ring::is_shm_address(hub_address_)) {
+            channel_ = grpc::CreateChannel(hub_address_,
+                                           grpc::InsecureChannelCredentials());
+            if (channel_) {
+                channel_->GetState(true);
+                stub_ = hub::HubService::NewStub(channel_);
+            }
+        }
+
         try {
-            // Register plugins using factory functions
-            std::cout << "[cpp-worker] Registering hello_cpp plugin...\n";
-            plugin_manager_.register_plugin(create_hello_cpp_plugin());
-            
-            std::cout << "[cpp-worker] Registering string_ops plugin...\n";
-            plugin_manager_.register_plugin(create_string_ops_plugin());
-            
+            // Builtins self-register via REGISTER_PLUGIN and were
+            // instantiated by the PluginManager constructor; only
+            // plugins needing constructor arguments are added by hand.
+            std::cout << "[cpp-worker] " << plugin_manager_.plugin_count()
+                      << " builtin plugin(s) registered\n";
+
+            std::cout << "[cpp-worker] Registering worker_stats plugin...\n";
+            plugin_manager_.register_plugin(create_worker_stats_plugin(&plugin_manager_));
+
+            // Shared-library plugins: .so files exposing create_plugin(),
+            // registered lazily from the capabilities manifest when cached.
+            const char* plugin_dir = std::getenv("PLUGIN_DIR");
+            if (plugin_dir && *plugin_dir) {
+                size_t loaded = plugin_manager_.load_directory(plugin_dir);
+                std::cout << "[cpp-worker] Loaded " << loaded
+                          << " shared plugin(s) from " << plugin_dir << "\n";
+            }
+
             std::cout << "[cpp-worker] ✅ Plugins registered successfully\n";
         } catch (const std::exception& e) {
             std::cerr << "[cpp-worker] ❌ Error in constructor: " << e.what() << "\n";
@@ -201,21 +998,48 @@ public:
     }
 
     bool connect() {
+        // Co-located fast path: attach to the hub-created segment. A
+        // missing segment fails like a refused connection — the
+        // supervisor retries with backoff until the hub creates it.
+        if (shm_ring::is_shm_address(hub_address_)) {
+            try {
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                shm_ = shm_ring::Conduit::attach(
+                    shm_ring::shm_name(hub_address_));
+                std::cout << "[cpp-worker] ✓ Attached shm conduit "
+                          << shm_ring::shm_name(hub_address_) << "\n";
+                return true;
+            } catch (const std::exception& e) {
+                std::cerr << "[cpp-worker] ❌ " << e.what() << "\n";
+                return false;
+            }
+        }
+
         try {
             std::cout << "[cpp-worker] Connecting to Hub at " << hub_address_ << "...\n";
-            
-            auto channel = grpc::CreateChannel(hub_address_, 
-                                              grpc::InsecureChannelCredentials());
-            
-            if (!channel) {
+
+            // Warmed in the constructor; only rebuilt if that failed.
+            if (!channel_) {
+                channel_ = grpc::CreateChannel(hub_address_,
+                                               grpc::InsecureChannelCredentials());
+            }
+
+            if (!channel_) {
                 std::cerr << "[cpp-worker] ❌ Failed to create gRPC channel\n";
                 return false;
             }
-            
+
             std::cout << "[cpp-worker] ✓ Channel created\n";
-            
-            stub_ = hub::HubService::NewStub(channel);
-            
+
+            // Normally built in the constructor alongside the channel;
+            // only built here if that path was skipped. Rebuilding it
+            // per session would yank the stub out from under a
+            // dispatch thread mid-download — stubs are thread-safe and
+            // the channel persists, so one stub serves every session.
+            if (!stub_) {
+                stub_ = hub::HubService::NewStub(channel_);
+            }
+
             if (!stub_) {
                 std::cerr << "[cpp-worker] ❌ Failed to create stub\n";
                 return false;
@@ -223,66 +1047,698 @@ public:
             
             std::cout << "[cpp-worker] ✓ Stub created\n";
             
-            // Context must outlive the stream!
-            context_ = std::make_unique<ClientContext>();
-            stream_ = stub_->Connect(context_.get());
-            
+            // Context must outlive the stream! The swap happens under
+            // the write mutex so no straggler from the previous session
+            // can dereference a half-replaced stream.
+            {
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                context_ = std::make_unique<ClientContext>();
+                stream_ = stub_->Connect(context_.get());
+            }
+
             if (!stream_) {
                 std::cerr << "[cpp-worker] ❌ Failed to connect stream\n";
                 return false;
             }
             
             std::cout << "[cpp-worker] ✓ Connected to Hub\n";
+
+            // Extra streams (WORKER_STREAMS > 1) on the same channel.
+            // Opening fewer than asked is not fatal — the worker runs
+            // with whatever the hub accepted.
+            for (size_t i = 1; i < streamCountFromEnv(); i++) {
+                auto extra = std::make_unique<ExtraStream>();
+                extra->context = std::make_unique<ClientContext>();
+                extra->stream = stub_->Connect(extra->context.get());
+                if (!extra->stream) {
+                    std::cerr << "[cpp-worker] ⚠ Extra stream " << i
+                              << " failed to connect\n";
+                    continue;
+                }
+                // The hello must be the stream's very first frame — the
+                // hub identifies the connection by it. A stream that
+                // cannot take the hello is dead on arrival and dropped.
+                if (!extra->stream->Write(buildStreamHello(worker_id_, i))) {
+                    std::cerr << "[cpp-worker] ⚠ Extra stream " << i
+                              << " rejected hello\n";
+                    extra->stream->Finish();
+                    continue;
+                }
+                extra->open = true;
+                extra_streams_.push_back(std::move(extra));
+            }
+            if (!extra_streams_.empty()) {
+                std::cout << "[cpp-worker] ✓ " << extra_streams_.size() + 1
+                          << " parallel hub streams\n";
+            }
             return true;
-            
+
         } catch (const std::exception& e) {
             std::cerr << "[cpp-worker] ❌ Exception in connect(): " << e.what() << "\n";
             return false;
         }
     }
 
-    void run() {
+    // Dedicated timer thread: beats every interval while a stream is up.
+    // Beats go through the write batcher, so a beat fired while responses
+    // are pending coalesces into the same corked write rather than paying
+    // its own syscall.
+    void heartbeatLoop(std::chrono::seconds interval) {
+        std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+        while (!heartbeat_cv_.wait_for(lock, interval,
+                                       [this] { return heartbeat_stop_; })) {
+            if (!running_) {
+                continue;  // between streams; registration will announce us
+            }
+            hub::Message* beat = message_arena_.acquire();
+            buildHeartbeat(worker_id_, dispatch_pool_.queue_depth(),
+                           in_flight_.load(std::memory_order_relaxed), *beat);
+            write_batcher_.enqueue(beat);
+        }
+    }
+
+    void startHeartbeat() {
+        auto interval = heartbeatIntervalFromEnv();
+        if (interval.count() == 0 || heartbeat_thread_.joinable()) {
+            return;
+        }
+        heartbeat_stop_ = false;
+        heartbeat_thread_ = std::thread([this, interval] {
+            heartbeatLoop(interval);
+        });
+    }
+
+    void stopHeartbeat() {
+        {
+            std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+            heartbeat_stop_ = true;
+        }
+        heartbeat_cv_.notify_all();
+        if (heartbeat_thread_.joinable()) {
+            heartbeat_thread_.join();
+        }
+    }
+
+    // Periodic stats dump interval (STATS_DUMP_INTERVAL_S, 0 disables).
+    static std::chrono::seconds statsIntervalFromEnv() {
+        const char* env = std::getenv("STATS_DUMP_INTERVAL_S");
+        if (env) {
+            long s = std::atol(env);
+            if (s >= 0) {
+                return std::chrono::seconds(s);
+            }
+        }
+        return std::chrono::seconds(60);
+    }
+
+    // Half-closes the write side exactly once per stream (drain and the
+    // normal session teardown can both get here).
+    void closeWrites() {
+        if (writes_done_.exchange(true)) {
+            return;
+        }
+        // Pull the extra streams out of the routing rotation before any
+        // half-close fires: the drain path gets here while the flusher
+        // and readers are still up, and a straggler routed onto an
+        // extra stream after its WritesDone() would be the same API
+        // violation the writes_done_ guard closes on the primary. With
+        // the rotation zeroed and each open flag down, stragglers fall
+        // through to the primary's fail-fast path instead.
+        active_extra_streams_.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (shm_) {
+                shm_->close_writes();
+            } else if (stream_) {
+                stream_->WritesDone();
+            }
+        }
+        for (auto& extra : extra_streams_) {
+            std::lock_guard<std::mutex> lock(extra->write_mutex);
+            if (extra->open) {
+                extra->open = false;
+                extra->stream->WritesDone();
+            }
+        }
+    }
+
+    // Drain deadline for in-flight work on SIGTERM (DRAIN_TIMEOUT_S).
+    static std::chrono::seconds drainTimeoutFromEnv() {
+        const char* env = std::getenv("DRAIN_TIMEOUT_S");
+        if (env) {
+            long s = std::atol(env);
+            if (s >= 0) {
+                return std::chrono::seconds(s);
+            }
+        }
+        return std::chrono::seconds(10);
+    }
+
+    // One stream session: register, serve until the stream breaks, then
+    // close it out. Returns the stream's final status. The dispatch pool,
+    // batcher, and plugin state stay warm across sessions.
+    Status runStream() {
         running_ = true;
-        
-        // Send registration
+        writes_done_ = false;  // fresh stream, fresh half-close
+        // Responses stranded by the previous session die here rather
+        // than leaking onto the new stream; then the flusher restarts
+        // against the fresh stream.
+        write_batcher_.discard_pending();
+        write_batcher_.start();
+
         sendRegistration();
-        
+
+        // The hub may spread requests across any of the parallel
+        // streams, so each extra stream gets its own blocking reader. A
+        // lost extra stream ends the whole session — the supervisor
+        // rebuilds all streams together rather than limping on a subset.
+        active_extra_streams_.store(extra_streams_.size(),
+                                    std::memory_order_relaxed);
+        for (auto& extra : extra_streams_) {
+            ExtraStream* raw = extra.get();
+            extra->reader = std::thread([this, raw] {
+                receiveLoop([raw](hub::Message* msg) {
+                    return raw->stream->Read(msg);
+                });
+                if (!draining_ && running_.exchange(false)) {
+                    if (context_) {
+                        context_->TryCancel();  // unblocks the primary reader
+                    }
+                }
+            });
+        }
+
         std::cout << "[cpp-worker] 📨 Listening for requests...\n";
-        
-        // Start receive loop
-        receiveLoop();
-        
+        receiveLoop([this](hub::Message* msg) { return readNext(msg); });
+
         running_ = false;
-        stream_->WritesDone();
+        // Quiesce the flusher before the half-close: everything still
+        // queued is flushed while the stream can take it, and after
+        // closeWrites() the write guards fail fast — nothing races
+        // WritesDone()/Finish() or the stream swap on reconnect.
+        write_batcher_.stop();
+        closeWrites();
+        teardownExtraStreams();
+        if (shm_) {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            shm_.reset();  // detach; a reconnect re-attaches
+            return Status::OK;
+        }
         Status status = stream_->Finish();
-        
         if (!status.ok()) {
-            std::cerr << "[cpp-worker] Connection error: " 
+            std::cerr << "[cpp-worker] Connection error: "
                       << status.error_message() << "\n";
         }
+        return status;
+    }
+
+    // Closes out the extra streams once the session is over: routing
+    // already points back at the primary (active_extra_streams_ is
+    // zeroed by then), readers unblock via cancel, and each stream ends
+    // with Finish(). Statuses are ignored — the session's fate is the
+    // primary stream's status.
+    void teardownExtraStreams() {
+        active_extra_streams_.store(0, std::memory_order_relaxed);
+        for (auto& extra : extra_streams_) {
+            if (extra->context) {
+                extra->context->TryCancel();
+            }
+        }
+        for (auto& extra : extra_streams_) {
+            if (extra->reader.joinable()) {
+                extra->reader.join();
+            }
+            {
+                std::lock_guard<std::mutex> lock(extra->write_mutex);
+                extra->open = false;
+            }
+            extra->stream->Finish();
+        }
+        extra_streams_.clear();
+    }
+
+    // Jittered exponential backoff: 100ms doubling to a 5s cap, scaled by
+    // a random factor in [0.5, 1.0) so a restarted hub isn't hit by the
+    // whole fleet at once. First reconnect lands well under a second.
+    // The generator is seeded per process from random_device — unseeded
+    // rand() gave every worker in the fleet the identical "jitter"
+    // sequence, which is no jitter at all.
+    static std::chrono::milliseconds backoffDelay(int attempt) {
+        long base_ms = 100;
+        long cap_ms = 5000;
+        long delay = base_ms << std::min(attempt, 6);
+        if (delay > cap_ms) {
+            delay = cap_ms;
+        }
+        static std::mt19937 rng{std::random_device{}()};
+        std::uniform_real_distribution<double> jitter(0.5, 1.0);
+        return std::chrono::milliseconds(
+            static_cast<long>(delay * jitter(rng)));
+    }
+
+public:
+    // Connection supervisor: keeps the worker attached to the hub for the
+    // life of the process. Stream failure tears down only the stream —
+    // plugins, pools, and stats stay warm — and the next attempt
+    // re-registers capabilities on the fresh stream.
+    void supervise() {
+        // This thread runs receiveLoop() and deserializes every
+        // hub::Message; parking it near the NIC keeps those buffers
+        // node-local for the dispatch threads that consume them.
+        if (cpu_affinity::pin_current_thread(
+                cpu_affinity::cpuset_from_env("READER_CPUSET"))) {
+            std::cout << "[cpp-worker] Reader pinned to READER_CPUSET\n";
+        }
+
+        AsyncLogger::instance().start();
+        dispatch_pool_.start();
+        write_batcher_.start();
+        WorkerMetrics::instance().start_periodic_dump(
+            statsIntervalFromEnv(), [this] {
+                return json{
+                    {"plugins", plugin_manager_.get_statistics()},
+                    {"stages", WorkerMetrics::instance().stages_json()}
+                };
+            });
+
+        worker_calls_.start();
+        startHeartbeat();
+
+        int attempt = 0;
+        while (!stopped_) {
+            if (connect()) {
+                attempt = 0;
+                runStream();
+                // Downstream replies can't arrive on the dead stream.
+                worker_calls_.fail_all("hub stream lost");
+                if (stopped_) {
+                    break;
+                }
+                std::cout << "[cpp-worker] Stream lost, reconnecting...\n";
+            }
+            attempt++;
+            std::this_thread::sleep_for(backoffDelay(attempt));
+        }
+
+        stopHeartbeat();
+        dispatch_pool_.stop();   // drains queued requests
+        write_batcher_.stop();   // flushes what can still be written
+        worker_calls_.stop();
+        WorkerMetrics::instance().stop_periodic_dump();
+        AsyncLogger::instance().stop();  // flushes the ring
     }
 
     void shutdown() {
+        stopped_ = true;
         running_ = false;
+        if (context_) {
+            context_->TryCancel();  // unblocks the reader
+        }
+        for (auto& extra : extra_streams_) {
+            if (extra->context) {
+                extra->context->TryCancel();
+            }
+        }
+    }
+
+    // Graceful drain for rolling deploys: tell the hub to reroute, let
+    // in-flight executions finish within DRAIN_TIMEOUT_S, flush queued
+    // responses, then half-close so the stream ends with WritesDone()/
+    // Finish() instead of a cancel. A second SIGTERM skips straight to
+    // the hard shutdown.
+    void drain() {
+        if (draining_.exchange(true)) {
+            shutdown();
+            return;
+        }
+        stopped_ = true;  // no reconnect after this stream ends
+
+        // Tell the hub first so new requests stop arriving while we
+        // finish the ones already here.
+        hub::Message notice;
+        notice.set_type(hub::MessageType::DIRECT);
+        notice.set_from(worker_id_);
+        notice.set_to("hub");
+        notice.set_timestamp(isoTimestamp());
+        (*notice.mutable_metadata())["event"] = "draining";
+        writeMessage(notice);
+
+        auto deadline = std::chrono::steady_clock::now() + drainTimeoutFromEnv();
+        while (std::chrono::steady_clock::now() < deadline &&
+               (in_flight_.load(std::memory_order_relaxed) > 0 ||
+                dispatch_pool_.queue_depth() > 0 ||
+                write_batcher_.pending() > 0)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        size_t abandoned = in_flight_.load(std::memory_order_relaxed) +
+                           dispatch_pool_.queue_depth();
+        if (abandoned > 0) {
+            std::cerr << "[cpp-worker] Drain deadline hit with " << abandoned
+                      << " request(s) still in flight\n";
+            // Ask cooperating plugins to bail: every ExecutionContext
+            // of this worker shares this token (see expired()).
+            cancel_requests_->store(true, std::memory_order_relaxed);
+        }
+
+        // Half-close; the hub finishes the stream, the reader unblocks,
+        // and runStream() closes out with a clean Finish(). If the hub
+        // never answers, fall back to a cancel at the same deadline.
+        closeWrites();
+        auto grace = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (running_ && std::chrono::steady_clock::now() < grace) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (running_) {
+            if (context_) {
+                context_->TryCancel();
+            }
+            running_ = false;  // also unblocks an shm recv
+        }
+    }
+};
+
+// Async worker built on the gRPC callback API. Unlike CPPWorkerGRPC there
+// is no thread parked in a blocking Read() per stream — gRPC invokes the
+// reactor callbacks from its own event threads, reads overlap with plugin
+// execution, and one process can hold streams to several hubs
+// (comma-separated HUB_ADDRESS). Selected with WORKER_ASYNC=1.
+class CPPWorkerAsync {
+private:
+    // One bidi stream to one hub. The reactor enforces gRPC's rule of at
+    // most one outstanding StartWrite() by queueing outgoing messages.
+    class HubStream final : public grpc::ClientBidiReactor<hub::Message, hub::Message> {
+    public:
+        HubStream(CPPWorkerAsync* owner, const std::string& address)
+            : owner_(owner), address_(address) {
+            channel_ = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+            // Warm the handshake while registration is still being built.
+            channel_->GetState(true);
+            stub_ = hub::HubService::NewStub(channel_);
+        }
+
+        void begin(hub::Message registration) {
+            stub_->async()->Connect(&context_, this);
+            enqueueWrite(std::move(registration));
+            StartRead(&incoming_);
+            StartCall();
+        }
+
+        void enqueueWrite(hub::Message msg) {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (write_in_flight_) {
+                write_queue_.push_back(std::move(msg));
+            } else {
+                outgoing_ = std::move(msg);
+                write_in_flight_ = true;
+                StartWrite(&outgoing_);
+            }
+        }
+
+        void OnReadDone(bool ok) override {
+            if (!ok) {
+                return;
+            }
+            if (incoming_.type() == hub::MessageType::REQUEST) {
+                owner_->dispatch(incoming_, this);
+            }
+            StartRead(&incoming_);
+        }
+
+        void OnWriteDone(bool ok) override {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (!ok) {
+                write_in_flight_ = false;
+                write_queue_.clear();
+                return;
+            }
+            if (!write_queue_.empty()) {
+                outgoing_ = std::move(write_queue_.front());
+                write_queue_.pop_front();
+                StartWrite(&outgoing_);
+            } else {
+                write_in_flight_ = false;
+            }
+        }
+
+        void OnDone(const Status& status) override {
+            {
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                status_ = status;
+                done_ = true;
+            }
+            done_cv_.notify_all();
+        }
+
+        Status await() {
+            std::unique_lock<std::mutex> lock(done_mutex_);
+            done_cv_.wait(lock, [this] { return done_; });
+            return status_;
+        }
+
+        void cancel() { context_.TryCancel(); }
+
+        const std::string& address() const { return address_; }
+
+    private:
+        CPPWorkerAsync* owner_;
+        std::string address_;
+        std::shared_ptr<Channel> channel_;
+        std::unique_ptr<hub::HubService::Stub> stub_;
+        ClientContext context_;
+        hub::Message incoming_;
+        hub::Message outgoing_;
+        std::mutex write_mutex_;
+        std::deque<hub::Message> write_queue_;
+        bool write_in_flight_ = false;
+        std::mutex done_mutex_;
+        std::condition_variable done_cv_;
+        bool done_ = false;
+        Status status_;
+    };
+
+    std::string worker_id_;
+    std::vector<std::string> hub_addresses_;
+    std::vector<std::unique_ptr<HubStream>> streams_;
+    PluginManager plugin_manager_;
+    DispatchPool dispatch_pool_;
+    std::atomic<size_t> in_flight_{0};
+    std::thread heartbeat_thread_;
+    std::mutex heartbeat_mutex_;
+    std::condition_variable heartbeat_cv_;
+    bool heartbeat_stop_ = false;
+
+    static size_t threadCountFromEnv() {
+        const char* env = std::getenv("WORKER_THREADS");
+        if (env) {
+            int count = std::atoi(env);
+            if (count > 0) {
+                return static_cast<size_t>(count);
+            }
+        }
+        return 0;
+    }
+
+    static size_t queueDepthFromEnv() {
+        const char* env = std::getenv("DISPATCH_QUEUE_DEPTH");
+        if (env) {
+            long depth = std::atol(env);
+            if (depth > 0) {
+                return static_cast<size_t>(depth);
+            }
+        }
+        return 1024;
+    }
+
+    void dispatch(const hub::Message& msg, HubStream* stream) {
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = deadlineFor(msg);
+        bool admitted = dispatch_pool_.try_submit(
+            [this, msg, stream, deadline] {
+                // Same dead-on-arrival check as the sync worker: skip
+                // requests whose deadline lapsed in the queue.
+                if (expiredAt(deadline)) {
+                    WorkerMetrics::instance().dropped_expired
+                        .fetch_add(1, std::memory_order_relaxed);
+                    LOG_DEBUG("[cpp-worker] Dropping expired request "
+                              << msg.id());
+                    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                ExecutionContext ctx;
+                ctx.worker_id = worker_id_;
+                ctx.deadline = deadline;
+                ctx.arena = &request_arena;
+                ctx.parallel_for = [this](size_t count,
+                                          const std::function<void(size_t)>& body) {
+                    dispatch_pool_.parallel_for(count, body);
+                };
+                hub::Message response;
+                {
+                    RequestArena::Scope scope(ctx.arena);
+                    processRequest(msg, worker_id_, plugin_manager_, response,
+                                   &ctx);
+                }
+                stream->enqueueWrite(std::move(response));
+                ctx.arena->reset();
+                in_flight_.fetch_sub(1, std::memory_order_relaxed);
+            },
+            laneFor(msg));
+        if (!admitted) {
+            in_flight_.fetch_sub(1, std::memory_order_relaxed);
+            size_t depth = dispatch_pool_.queue_depth();
+            LOG_WARN("[cpp-worker] Shedding request " << msg.id()
+                     << " (queue depth " << depth << ")");
+            hub::Message rejection;
+            buildOverloadResponse(msg, worker_id_, depth, rejection);
+            stream->enqueueWrite(std::move(rejection));
+        }
+    }
+
+public:
+    CPPWorkerAsync(const std::string& worker_id, const std::string& hub_addresses)
+        : worker_id_(worker_id),
+          dispatch_pool_(threadCountFromEnv(), queueDepthFromEnv()) {
+
+        // A worker can shard across hubs: HUB_ADDRESS takes a
+        // comma-separated list, one stream per hub.
+        size_t start = 0;
+        while (start <= hub_addresses.size()) {
+            size_t comma = hub_addresses.find(',', start);
+            if (comma == std::string::npos) {
+                comma = hub_addresses.size();
+            }
+            std::string address = hub_addresses.substr(start, comma - start);
+            if (!address.empty()) {
+                hub_addresses_.push_back(address);
+            }
+            start = comma + 1;
+        }
+
+        std::cout << "[cpp-worker] 🔵 Initializing C++ Worker (async)...\n";
+        std::cout << "[cpp-worker] Worker ID: " << worker_id_ << "\n";
+        std::cout << "[cpp-worker] Hub streams: " << hub_addresses_.size() << "\n";
+        std::cout << "[cpp-worker] Dispatch threads: " << dispatch_pool_.thread_count() << "\n";
+
+        // Same operator topology knob as the sync worker; the gRPC event
+        // threads are the callback API's own, so only the pool is placed.
+        dispatch_pool_.set_cpuset(cpu_affinity::cpuset_from_env("WORKER_CPUSET"));
+
+        // Builtins arrive via the REGISTER_PLUGIN static-init table;
+        // worker_stats needs the manager pointer, so it stays manual.
+        plugin_manager_.register_plugin(create_worker_stats_plugin(&plugin_manager_));
+        const char* plugin_dir = std::getenv("PLUGIN_DIR");
+        if (plugin_dir && *plugin_dir) {
+            plugin_manager_.load_directory(plugin_dir);
+        }
+    }
+
+    // Opens every hub stream, registers on each, and blocks until all of
+    // them finish.
+    void run() {
+        AsyncLogger::instance().start();
+        dispatch_pool_.start();
+
+        for (const auto& address : hub_addresses_) {
+            std::cout << "[cpp-worker] Connecting to Hub at " << address << "...\n";
+            auto stream = std::make_unique<HubStream>(this, address);
+            stream->begin(buildRegistration(worker_id_, plugin_manager_));
+            streams_.push_back(std::move(stream));
+        }
+
+        std::cout << "[cpp-worker] 📨 Listening for requests...\n";
+
+        // One timer thread beats every stream; enqueueWrite rides the
+        // reactor's write queue, so a beat coalesces behind any response
+        // writes already in flight.
+        auto heartbeat_interval = heartbeatIntervalFromEnv();
+        if (heartbeat_interval.count() > 0) {
+            heartbeat_thread_ = std::thread([this, heartbeat_interval] {
+                std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+                while (!heartbeat_cv_.wait_for(lock, heartbeat_interval,
+                                               [this] { return heartbeat_stop_; })) {
+                    hub::Message beat;
+                    buildHeartbeat(worker_id_, dispatch_pool_.queue_depth(),
+                                   in_flight_.load(std::memory_order_relaxed),
+                                   beat);
+                    for (auto& stream : streams_) {
+                        stream->enqueueWrite(beat);
+                    }
+                }
+            });
+        }
+
+        for (auto& stream : streams_) {
+            Status status = stream->await();
+            if (!status.ok()) {
+                std::cerr << "[cpp-worker] Connection error (" << stream->address()
+                          << "): " << status.error_message() << "\n";
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+            heartbeat_stop_ = true;
+        }
+        heartbeat_cv_.notify_all();
+        if (heartbeat_thread_.joinable()) {
+            heartbeat_thread_.join();
+        }
+        dispatch_pool_.stop();
+        AsyncLogger::instance().stop();
+    }
+
+    void shutdown() {
+        for (auto& stream : streams_) {
+            stream->cancel();
+        }
     }
 };
 
-// Signal handling
+// Signal handling. The handler itself only records the signal and posts
+// a semaphore (the one async-signal-safe primitive here) — drain() takes
+// stream mutexes and calls into gRPC, and running that on whatever
+// thread the signal interrupted can re-acquire a lock that thread
+// already holds. A dedicated dispatch thread does the real work.
 std::unique_ptr<CPPWorkerGRPC> worker_instance;
+std::unique_ptr<CPPWorkerAsync> async_worker_instance;
+sem_t signal_sem;
+volatile sig_atomic_t pending_signal = 0;
 
 void signalHandler(int signum) {
-    std::cout << "\n[cpp-worker] Received signal " << signum << ", shutting down...\n";
-    if (worker_instance) {
-        worker_instance->shutdown();
+    pending_signal = signum;
+    sem_post(&signal_sem);
+}
+
+void signalDispatchLoop() {
+    for (;;) {
+        sem_wait(&signal_sem);
+        int signum = pending_signal;
+        if (signum == SIGTERM && worker_instance) {
+            // Rolling deploy path: finish in-flight work, flush
+            // responses, and end the stream cleanly; main() unwinds once
+            // supervise() returns. Drain runs on its own thread so a
+            // second SIGTERM can still force the hard stop (see drain()).
+            std::cout << "\n[cpp-worker] Received SIGTERM, draining...\n";
+            std::thread([] { worker_instance->drain(); }).detach();
+            continue;
+        }
+        std::cout << "\n[cpp-worker] Received signal " << signum
+                  << ", shutting down...\n";
+        if (worker_instance) {
+            worker_instance->shutdown();
+        }
+        if (async_worker_instance) {
+            async_worker_instance->shutdown();
+        }
+        std::exit(signum);
     }
-    exit(signum);
 }
 
 int main() {
-    // Explicitly set unbuffered output for debugging
-    std::cout.setf(std::ios::unitbuf);
-    std::cerr.setf(std::ios::unitbuf);
-    
+    // Startup/shutdown logs stay synchronous on std::cout; the request
+    // path logs through AsyncLogger (no unitbuf — every request line used
+    // to cost several unbuffered write() syscalls).
     std::cout << "[cpp-worker] 🚀 Starting C++ Worker (step 1)...\n";
     
     // Initialize Google's logging library used by gRPC/protobuf
@@ -290,33 +1746,37 @@ int main() {
     
     try {
         std::cout << "[cpp-worker] 🚀 Step 2: Setting up signal handlers...\n";
-        
+
+        sem_init(&signal_sem, 0, 0);
+        std::thread(signalDispatchLoop).detach();
         signal(SIGINT, signalHandler);
         signal(SIGTERM, signalHandler);
         
         std::cout << "[cpp-worker] 🚀 Step 3: Declaring variables...\n" << std::flush;
-        const std::string worker_id = "cpp-worker";
-        const std::string hub_address = "localhost:50051";
-        
+        const char* worker_id_env = std::getenv("WORKER_ID");
+        const char* hub_address_env = std::getenv("HUB_ADDRESS");
+        const std::string worker_id = worker_id_env ? worker_id_env : "cpp-worker";
+        const std::string hub_address = hub_address_env ? hub_address_env : "localhost:50051";
+
+        // WORKER_ASYNC=1 selects the callback-API worker (multiple hub
+        // streams, no blocking reader thread).
+        const char* async_env = std::getenv("WORKER_ASYNC");
+        if (async_env && std::string(async_env) == "1") {
+            async_worker_instance = std::make_unique<CPPWorkerAsync>(worker_id, hub_address);
+            async_worker_instance->run();
+            std::cout << "[cpp-worker] Worker finished\n";
+            return 0;
+        }
+
         std::cout << "[cpp-worker] 🚀 Step 4: Creating worker instance...\n" << std::flush;
         worker_instance = std::make_unique<CPPWorkerGRPC>(worker_id, hub_address);
         std::cout << "[cpp-worker] ✅ Worker instance created\n" << std::flush;
-        
-        // Retry connection
-        int max_retries = 10;
-        int retry_delay = 2;
-        
-        for (int i = 0; i < max_retries; i++) {
-            if (worker_instance->connect()) {
-                worker_instance->run();
-                break;
-            }
-            
-            std::cout << "[cpp-worker] Retry " << (i+1) << "/" << max_retries 
-                      << " in " << retry_delay << "s...\n";
-            std::this_thread::sleep_for(std::chrono::seconds(retry_delay));
-        }
-        
+
+        // The supervisor owns the connect/serve/reconnect cycle for the
+        // life of the process (replaces the old 10x fixed-delay retry loop
+        // that exited permanently).
+        worker_instance->supervise();
+
         std::cout << "[cpp-worker] Worker finished\n";
         return 0;
         
@@ -0,0 +1,554 @@
+// Benchmark harness for the C++ worker. Two modes:
+//
+//   cpp-worker-bench --micro
+//       In-process microbenchmarks of PluginManager::execute and each
+//       bundled plugin (no gRPC involved), reporting ns/op.
+//
+//   cpp-worker-bench [--requests N] [--concurrency C] [--trace FILE]
+//                    [--worker PATH] [--shm]
+//       Stands up an in-process gRPC server implementing
+//       HubService::Connect, spawns a real cpp-worker pointed at it over
+//       loopback, replays a request trace at the given in-flight window
+//       and reports req/s plus latency percentiles. A trace file is
+//       newline-delimited JSON objects {"capability": ..., "params": ...};
+//       without one a synthetic hello_cpp/string_ops mix is replayed.
+//       With --shm the hub side is a shared-memory conduit (see
+//       shm_ring.h) instead of a gRPC server, exercising the co-located
+//       fast path end to end.
+//
+// This keeps perf claims measurable without standing up the Go hub.
+
+#include <grpcpp/grpcpp.h>
+#include "hub.grpc.pb.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <deque>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "latency_histogram.h"
+#include "plugin_manager.h"
+#include "shm_ring.h"
+
+
+extern PluginPtr create_worker_stats_plugin(PluginManager* manager);
+
+namespace {
+
+struct TraceEntry {
+    std::string capability;
+    std::string params;  // pre-dumped JSON, what goes into Message.content
+};
+
+struct BenchOptions {
+    size_t requests = 10000;
+    size_t concurrency = 32;
+    std::string trace_path;
+    std::string worker_path = "./cpp-worker";
+    bool micro = false;
+    bool shm = false;
+    size_t streams = 1;  // worker-side WORKER_STREAMS
+};
+
+std::vector<TraceEntry> loadTrace(const std::string& path) {
+    std::vector<TraceEntry> trace;
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open trace file: " << path << "\n";
+        return trace;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        try {
+            json entry = json::parse(line);
+            TraceEntry te;
+            te.capability = entry.value("capability", "");
+            te.params = entry.value("params", json::object()).dump();
+            if (!te.capability.empty()) {
+                trace.push_back(std::move(te));
+            }
+        } catch (const json::exception& e) {
+            std::cerr << "skipping bad trace line: " << e.what() << "\n";
+        }
+    }
+    return trace;
+}
+
+// Default workload: the same mix the demo scripts drive through the hub.
+std::vector<TraceEntry> syntheticTrace() {
+    std::string text(64, 'x');
+    return {
+        {"hello_cpp", json({{"name", "bench"}}).dump()},
+        {"string_ops", json({{"operation", "upper"}, {"text", text}}).dump()},
+        {"string_ops", json({{"operation", "reverse"}, {"text", text}}).dump()},
+    };
+}
+
+void printPercentiles(const char* label, const LatencyHistogram& histogram) {
+    std::cout << label
+              << "  p50=" << histogram.percentile(0.50) / 1000.0 << "us"
+              << "  p95=" << histogram.percentile(0.95) / 1000.0 << "us"
+              << "  p99=" << histogram.percentile(0.99) / 1000.0 << "us\n";
+}
+
+// Transport-agnostic replay core: keeps at most `concurrency` requests
+// in flight against the worker, correlating requests to responses by
+// Message.id. The gRPC hub and the shm conduit both drive it, so both
+// transports run the identical workload.
+class ReplayDriver {
+public:
+    using ReadFn = std::function<bool(hub::Message&)>;
+    using WriteFn = std::function<bool(const hub::Message&)>;
+
+    ReplayDriver(std::vector<TraceEntry> trace, size_t requests,
+                 size_t concurrency)
+        : trace_(std::move(trace)), requests_(requests),
+          concurrency_(concurrency) {}
+
+    void run(const ReadFn& read, const WriteFn& write) {
+        auto bench_start = std::chrono::steady_clock::now();
+
+        // Reader: completes in-flight slots as responses arrive.
+        std::thread reader([&] {
+            hub::Message response;
+            while (read(response)) {
+                if (response.type() != hub::MessageType::RESPONSE) {
+                    continue;
+                }
+                std::chrono::steady_clock::time_point start;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = in_flight_.find(response.id());
+                    if (it == in_flight_.end()) {
+                        continue;
+                    }
+                    start = it->second;
+                    in_flight_.erase(it);
+                }
+                latency_.record(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+                try {
+                    if (!json::parse(response.content()).value("success", false)) {
+                        errors_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                } catch (const json::exception&) {
+                    errors_.fetch_add(1, std::memory_order_relaxed);
+                }
+                completed_.fetch_add(1, std::memory_order_relaxed);
+                slot_free_.notify_one();
+            }
+            slot_free_.notify_all();
+        });
+
+        // Writer: this thread. Blocks on a free slot, then sends the next
+        // trace entry.
+        for (size_t i = 0; i < requests_; i++) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                slot_free_.wait(lock, [&] {
+                    return in_flight_.size() < concurrency_;
+                });
+            }
+            const TraceEntry& entry = trace_[i % trace_.size()];
+            hub::Message request;
+            request.set_type(hub::MessageType::REQUEST);
+            request.set_id("bench-" + std::to_string(i));
+            request.set_from("bench-hub");
+            request.set_to("bench-worker");
+            request.set_content(entry.params);
+            (*request.mutable_metadata())["capability"] = entry.capability;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                in_flight_.emplace(request.id(),
+                                   std::chrono::steady_clock::now());
+            }
+            if (!write(request)) {
+                break;
+            }
+        }
+
+        // Drain the tail before tearing the transport down.
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slot_free_.wait_for(lock, std::chrono::seconds(30), [&] {
+                return in_flight_.empty();
+            });
+        }
+        elapsed_ = std::chrono::steady_clock::now() - bench_start;
+        done_.set_value();
+        reader.join();
+    }
+
+    void report() const {
+        uint64_t completed = completed_.load();
+        double seconds = std::chrono::duration<double>(elapsed_).count();
+        std::cout << "[bench] " << completed << " responses in " << seconds
+                  << "s  (" << (seconds > 0 ? completed / seconds : 0.0)
+                  << " req/s, " << errors_.load() << " errors)\n";
+        printPercentiles("[bench] latency", latency_);
+    }
+
+    std::future<void> doneFuture() { return done_.get_future(); }
+
+private:
+    std::vector<TraceEntry> trace_;
+    size_t requests_;
+    size_t concurrency_;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> in_flight_;
+    std::mutex mutex_;
+    std::condition_variable slot_free_;
+    LatencyHistogram latency_;
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::chrono::steady_clock::duration elapsed_{};
+    std::promise<void> done_;
+};
+
+// Loopback hub: the stream carrying REGISTER is the worker's primary —
+// it runs the replay and carries every request. A worker running with
+// WORKER_STREAMS > 1 opens extra Connect streams and shards its
+// responses across all of them by request id, so every stream is pumped
+// into one merged queue and the driver reads from that.
+class BenchHubService final : public hub::HubService::Service {
+public:
+    explicit BenchHubService(ReplayDriver& driver) : driver_(driver) {}
+
+    grpc::Status Connect(
+            grpc::ServerContext* /*context*/,
+            grpc::ServerReaderWriter<hub::Message, hub::Message>* stream) override {
+        hub::Message incoming;
+        if (!stream->Read(&incoming)) {
+            return grpc::Status::OK;  // stream ended without traffic
+        }
+        if (incoming.type() != hub::MessageType::REGISTER) {
+            // Extra stream: its first frame is the stream-attach hello.
+            // It rides the merged queue like everything else; the driver
+            // skips non-RESPONSE messages.
+            push(std::move(incoming));
+            pump(stream);
+            return grpc::Status::OK;
+        }
+        // The worker reconnects after the replay stream ends; only the
+        // first REGISTER runs the benchmark.
+        if (registered_.exchange(true)) {
+            return grpc::Status(grpc::StatusCode::UNAVAILABLE, "bench done");
+        }
+        std::cout << "[bench] worker registered: " << incoming.from() << "\n";
+
+        // The primary stream is pumped like the extras; the merged queue
+        // closes when it ends, which ends the driver's reader.
+        std::thread reader([this, stream] {
+            pump(stream);
+            close();
+        });
+        driver_.run(
+            [this](hub::Message& msg) { return pop(msg); },
+            [&](const hub::Message& msg) { return stream->Write(msg); });
+        reader.join();
+        return grpc::Status::OK;
+    }
+
+private:
+    void pump(grpc::ServerReaderWriter<hub::Message, hub::Message>* stream) {
+        hub::Message msg;
+        while (stream->Read(&msg)) {
+            push(std::move(msg));
+        }
+    }
+
+    void push(hub::Message msg) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            queue_.push_back(std::move(msg));
+        }
+        queue_cv_.notify_one();
+    }
+
+    bool pop(hub::Message& msg) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return false;
+        }
+        msg = std::move(queue_.front());
+        queue_.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            closed_ = true;
+        }
+        queue_cv_.notify_all();
+    }
+
+    ReplayDriver& driver_;
+    std::atomic<bool> registered_{false};
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<hub::Message> queue_;
+    bool closed_ = false;
+};
+
+// Runs fn for `iterations` after a short warmup and prints ns/op. Same
+// shape as a google-benchmark case, without the dependency.
+void microBench(const std::string& name, size_t iterations,
+                const std::function<void()>& fn) {
+    for (size_t i = 0; i < iterations / 10; i++) {
+        fn();
+    }
+    LatencyHistogram histogram;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        auto op_start = std::chrono::steady_clock::now();
+        fn();
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - op_start).count());
+    }
+    double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << name << "  " << iterations << " iters  "
+              << total_ns / iterations << " ns/op\n";
+    printPercentiles(("  " + name).c_str(), histogram);
+}
+
+int runMicro() {
+    PluginManager manager;  // builtins arrive via REGISTER_PLUGIN
+    manager.register_plugin(create_worker_stats_plugin(&manager));
+
+    const size_t iterations = 100000;
+    std::string text(64, 'x');
+
+    // Dispatch overhead through the manager (lookup + stats + plugin).
+    json hello_params = {{"name", "bench"}};
+    microBench("PluginManager::execute/hello_cpp", iterations, [&] {
+        json params = hello_params;
+        manager.execute("hello_cpp", std::move(params), nullptr);
+    });
+
+    json upper_params = {{"operation", "upper"}, {"text", text}};
+    microBench("PluginManager::execute/string_ops-upper", iterations, [&] {
+        json params = upper_params;
+        manager.execute("string_ops", std::move(params), nullptr);
+    });
+
+    json reverse_params = {{"operation", "reverse"}, {"text", text}};
+    microBench("PluginManager::execute/string_ops-reverse", iterations, [&] {
+        json params = reverse_params;
+        manager.execute("string_ops", std::move(params), nullptr);
+    });
+
+    std::string raw = upper_params.dump();
+    microBench("PluginManager::execute_raw/string_ops", iterations, [&] {
+        manager.execute_raw("string_ops", raw, nullptr);
+    });
+
+    // Repeated params: everything after the first call is a cache hit.
+    microBench("PluginManager::execute_raw_serialized/cache-hit", iterations, [&] {
+        std::string out;
+        manager.execute_raw_serialized("string_ops", raw, nullptr, out);
+    });
+
+    microBench("PluginManager::execute/worker_stats", iterations / 10, [&] {
+        manager.execute("worker_stats", json::object(), nullptr);
+    });
+    return 0;
+}
+
+// Spawns the worker binary pointed at the given hub address; returns
+// its pid, or -1 on failure.
+pid_t spawnWorker(const BenchOptions& options, const std::string& address) {
+    pid_t worker = fork();
+    if (worker == 0) {
+        setenv("HUB_ADDRESS", address.c_str(), 1);
+        setenv("WORKER_ID", "bench-worker", 1);
+        if (options.streams > 1) {
+            setenv("WORKER_STREAMS",
+                   std::to_string(options.streams).c_str(), 1);
+        }
+        setenv("LOG_LEVEL", "warn", 1);
+        execl(options.worker_path.c_str(), options.worker_path.c_str(),
+              static_cast<char*>(nullptr));
+        std::cerr << "failed to exec " << options.worker_path << ": "
+                  << std::strerror(errno) << "\n";
+        _exit(127);
+    }
+    return worker;
+}
+
+// Shared-memory replay: the bench plays the hub side of the conduit in
+// this process, so the measured round-trip is ring-to-ring with no
+// network stack at all.
+int runShmReplay(const BenchOptions& options, std::vector<TraceEntry> trace) {
+    std::string name = "/cpp-worker-bench-" + std::to_string(getpid());
+    std::unique_ptr<shm_ring::Conduit> conduit;
+    try {
+        conduit = shm_ring::Conduit::create(name);
+    } catch (const std::exception& e) {
+        std::cerr << "failed to create shm conduit: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "[bench] shm conduit " << name << ", replaying "
+              << options.requests << " requests at concurrency "
+              << options.concurrency << "\n";
+
+    pid_t worker = spawnWorker(options, "shm:" + name);
+    if (worker < 0) {
+        std::cerr << "fork failed\n";
+        return 1;
+    }
+
+    int rc = 1;
+    hub::Message incoming;
+    std::thread replay;
+    ReplayDriver driver(std::move(trace), options.requests,
+                        options.concurrency);
+    if (conduit->recv(incoming) &&
+        incoming.type() == hub::MessageType::REGISTER) {
+        std::cout << "[bench] worker registered: " << incoming.from() << "\n";
+        // run() only returns once its reader sees EOF, and the rings
+        // only close when the worker tears down — so, like the gRPC
+        // mode, the replay runs on its own thread while this one waits
+        // for the drain, then shuts the worker down to unblock it.
+        // Writes funnel through one mutex on the worker, and this side
+        // reads on one thread and writes on one — matching the rings'
+        // SPSC contract.
+        std::future<void> done = driver.doneFuture();
+        replay = std::thread([&] {
+            driver.run(
+                [&](hub::Message& msg) { return conduit->recv(msg); },
+                [&](const hub::Message& msg) { return conduit->send(msg); });
+        });
+        if (done.wait_for(std::chrono::minutes(10)) ==
+            std::future_status::ready) {
+            driver.report();
+            rc = 0;
+        } else {
+            std::cerr << "[bench] timed out waiting for replay to finish\n";
+        }
+    } else {
+        std::cerr << "[bench] expected REGISTER as first message\n";
+    }
+
+    // Half-close our direction; the worker answers with its own close,
+    // which ends the replay reader.
+    conduit->close_writes();
+    kill(worker, SIGTERM);
+    if (replay.joinable()) {
+        replay.join();
+    }
+    int status = 0;
+    waitpid(worker, &status, 0);
+    return rc;
+}
+
+int runReplay(const BenchOptions& options) {
+    std::vector<TraceEntry> trace = options.trace_path.empty()
+                                        ? syntheticTrace()
+                                        : loadTrace(options.trace_path);
+    if (trace.empty()) {
+        std::cerr << "no usable trace entries\n";
+        return 1;
+    }
+    if (options.shm) {
+        return runShmReplay(options, std::move(trace));
+    }
+
+    ReplayDriver driver(std::move(trace), options.requests,
+                        options.concurrency);
+    BenchHubService service(driver);
+    std::future<void> done = driver.doneFuture();
+
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(),
+                             &port);
+    builder.RegisterService(&service);
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    if (!server || port == 0) {
+        std::cerr << "failed to start loopback hub\n";
+        return 1;
+    }
+    std::string address = "127.0.0.1:" + std::to_string(port);
+    std::cout << "[bench] loopback hub on " << address
+              << ", replaying " << options.requests << " requests at concurrency "
+              << options.concurrency << "\n";
+
+    pid_t worker = spawnWorker(options, address);
+    if (worker < 0) {
+        std::cerr << "fork failed\n";
+        return 1;
+    }
+
+    // The Connect handler signals when the replay is drained. Cap the
+    // wait so a wedged worker doesn't hang the bench.
+    auto deadline = std::chrono::minutes(10);
+    int rc = 0;
+    if (done.wait_for(deadline) == std::future_status::ready) {
+        driver.report();
+    } else {
+        std::cerr << "[bench] timed out waiting for replay to finish\n";
+        rc = 1;
+    }
+
+    kill(worker, SIGTERM);
+    server->Shutdown(std::chrono::system_clock::now() +
+                     std::chrono::seconds(2));
+    int status = 0;
+    waitpid(worker, &status, 0);
+    return rc;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--micro") {
+            options.micro = true;
+        } else if (arg == "--requests" && i + 1 < argc) {
+            options.requests = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            options.concurrency = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.trace_path = argv[++i];
+        } else if (arg == "--worker" && i + 1 < argc) {
+            options.worker_path = argv[++i];
+        } else if (arg == "--shm") {
+            options.shm = true;
+        } else if (arg == "--streams" && i + 1 < argc) {
+            options.streams = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--micro] [--requests N] [--concurrency C]"
+                         " [--trace FILE] [--worker PATH] [--shm]"
+                         " [--streams N]\n";
+            return 2;
+        }
+    }
+    if (options.concurrency == 0) {
+        options.concurrency = 1;
+    }
+    return options.micro ? runMicro() : runReplay(options);
+}
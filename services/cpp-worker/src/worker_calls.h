@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "request_arena.h"
+
+// Tracks in-flight worker-to-worker calls, correlated by the call id
+// carried in Message.id/request_id over the existing bidi stream. Each
+// call gets a promise; the stream reader completes it when the matching
+// RESPONSE arrives, so a plugin can launch several downstream calls and
+// await the futures together. A reaper thread fails calls whose deadline
+// passed, and fail_all() flushes everything when the stream dies.
+class WorkerCallRegistry {
+public:
+    // Promises are fulfilled from the stream reader thread, which runs
+    // with no arena in scope, so results are heap-backed and safe to
+    // hand across to the awaiting request.
+    using json = arena_json;
+
+    ~WorkerCallRegistry() {
+        stop();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (reaper_.joinable()) {
+            return;
+        }
+        stopping_ = false;
+        reaper_ = std::thread([this] { reapLoop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (reaper_.joinable()) {
+            reaper_.join();
+        }
+        fail_all("worker shutting down");
+    }
+
+    std::future<json> add(const std::string& call_id,
+                          std::chrono::milliseconds deadline) {
+        Pending pending;
+        pending.expires_at = std::chrono::steady_clock::now() + deadline;
+        std::future<json> future = pending.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.emplace(call_id, std::move(pending));
+        }
+        return future;
+    }
+
+    // Completes the call if it is still pending; returns false when the
+    // response belongs to no known call (e.g. it already timed out).
+    bool complete(const std::string& call_id, json&& result) {
+        Pending pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = pending_.find(call_id);
+            if (it == pending_.end()) {
+                return false;
+            }
+            pending = std::move(it->second);
+            pending_.erase(it);
+        }
+        pending.promise.set_value(std::move(result));
+        return true;
+    }
+
+    bool fail(const std::string& call_id, const std::string& reason) {
+        Pending pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = pending_.find(call_id);
+            if (it == pending_.end()) {
+                return false;
+            }
+            pending = std::move(it->second);
+            pending_.erase(it);
+        }
+        pending.promise.set_exception(
+            std::make_exception_ptr(std::runtime_error(reason)));
+        return true;
+    }
+
+    void fail_all(const std::string& reason) {
+        std::unordered_map<std::string, Pending> drained;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            drained.swap(pending_);
+        }
+        for (auto& pair : drained) {
+            pair.second.promise.set_exception(
+                std::make_exception_ptr(std::runtime_error(reason)));
+        }
+    }
+
+    size_t pending_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_.size();
+    }
+
+private:
+    struct Pending {
+        std::promise<json> promise;
+        std::chrono::steady_clock::time_point expires_at;
+    };
+
+    void reapLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, std::chrono::milliseconds(100),
+                             [this] { return stopping_; })) {
+            auto now = std::chrono::steady_clock::now();
+            std::vector<Pending> expired;
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                if (it->second.expires_at <= now) {
+                    expired.push_back(std::move(it->second));
+                    it = pending_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            lock.unlock();
+            for (auto& pending : expired) {
+                pending.promise.set_exception(std::make_exception_ptr(
+                    std::runtime_error("worker call deadline exceeded")));
+            }
+            lock.lock();
+        }
+    }
+
+    std::unordered_map<std::string, Pending> pending_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread reaper_;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "latency_histogram.h"
+#include "request_arena.h"
+
+// Process-wide instrumentation for the request hot path: one histogram
+// per pipeline stage (content parse, plugin execute, stream write, and
+// the whole request). Recording is a relaxed atomic add into the stage
+// histogram; reading happens from the worker_stats capability and the
+// periodic stderr dump.
+class WorkerMetrics {
+public:
+    static WorkerMetrics& instance() {
+        static WorkerMetrics metrics;
+        return metrics;
+    }
+
+    LatencyHistogram parse;
+    LatencyHistogram execute;
+    LatencyHistogram write;
+    LatencyHistogram total;
+    // Requests whose deadline_ms had already passed when a dispatch
+    // thread picked them up — skipped without executing the plugin.
+    std::atomic<uint64_t> dropped_expired{0};
+
+    arena_json stages_json() const {
+        return {
+            {"parse", stage_json(parse)},
+            {"execute", stage_json(execute)},
+            {"write", stage_json(write)},
+            {"total", stage_json(total)},
+            {"dropped_expired",
+             dropped_expired.load(std::memory_order_relaxed)}
+        };
+    }
+
+    // Dumps the supplied stats snapshot to stderr every interval.
+    // interval == 0 disables the dump thread.
+    void start_periodic_dump(std::chrono::seconds interval,
+                             std::function<arena_json()> snapshot) {
+        std::lock_guard<std::mutex> lock(dump_mutex_);
+        if (interval.count() == 0 || dumper_.joinable()) {
+            return;
+        }
+        dump_stop_ = false;
+        dumper_ = std::thread([this, interval, snapshot = std::move(snapshot)] {
+            std::unique_lock<std::mutex> lock(dump_mutex_);
+            while (!dump_cv_.wait_for(lock, interval,
+                                      [this] { return dump_stop_; })) {
+                lock.unlock();
+                std::cerr << "[cpp-worker] 📊 stats: " << snapshot().dump() << "\n";
+                lock.lock();
+            }
+        });
+    }
+
+    void stop_periodic_dump() {
+        {
+            std::lock_guard<std::mutex> lock(dump_mutex_);
+            if (!dumper_.joinable()) {
+                return;
+            }
+            dump_stop_ = true;
+        }
+        dump_cv_.notify_all();
+        dumper_.join();
+    }
+
+private:
+    WorkerMetrics() = default;
+    ~WorkerMetrics() {
+        stop_periodic_dump();
+    }
+
+    static arena_json stage_json(const LatencyHistogram& h) {
+        uint64_t count = h.count();
+        return {
+            {"count", count},
+            {"avg_us", count ? (h.sum_ns() / count) / 1000.0 : 0.0},
+            {"p50_us", h.percentile(0.50) / 1000.0},
+            {"p95_us", h.percentile(0.95) / 1000.0},
+            {"p99_us", h.percentile(0.99) / 1000.0}
+        };
+    }
+
+    std::mutex dump_mutex_;
+    std::condition_variable dump_cv_;
+    bool dump_stop_ = false;
+    std::thread dumper_;
+};
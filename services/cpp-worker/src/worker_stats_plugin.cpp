@@ -0,0 +1,35 @@
+#include "plugin.h"
+#include "plugin_manager.h"
+#include "worker_metrics.h"
+
+// Built-in capability returning the worker's instrumentation: per-plugin
+// call counts and latency percentiles plus the pipeline-stage histograms
+// (parse/execute/write/total). Callers hit it like any other capability.
+class WorkerStatsPlugin : public Plugin {
+public:
+    explicit WorkerStatsPlugin(PluginManager* manager) : manager_(manager) {}
+
+    std::string get_name() const override {
+        return "worker_stats";
+    }
+
+    std::string get_description() const override {
+        return "Returns per-plugin and pipeline-stage latency statistics";
+    }
+
+    json execute(const json& input, ExecutionContext* context = nullptr) override {
+        (void)input;
+        (void)context;
+        return {
+            {"plugins", manager_->get_statistics()},
+            {"stages", WorkerMetrics::instance().stages_json()}
+        };
+    }
+
+private:
+    PluginManager* manager_;
+};
+
+PluginPtr create_worker_stats_plugin(PluginManager* manager) {
+    return std::make_shared<WorkerStatsPlugin>(manager);
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cpu_affinity.h"
+#include "hub.pb.h"
+
+// Coalesces outgoing responses on the hub stream. Every individual
+// stream Write() pays a syscall and an HTTP/2 frame flush; under burst
+// load the connection becomes write-bound long before the NIC is busy.
+// Responses queue here and a dedicated flusher drains them once a small
+// window elapses or the batch fills, writing all but the last message
+// with gRPC's buffer_hint so only the final write of a batch flushes
+// the transport.
+class WriteBatcher {
+public:
+    // Sink writes one message to the stream; last_in_batch == false means
+    // the write may be buffered (buffer_hint), true forces the flush.
+    using Sink = std::function<bool(const hub::Message& msg, bool last_in_batch)>;
+    // Called once a queued message has been written, so pooled messages
+    // (see MessageArena) can be recycled.
+    using Release = std::function<void(hub::Message* msg)>;
+
+    WriteBatcher(Sink sink,
+                 std::chrono::microseconds window = std::chrono::microseconds(1000),
+                 size_t max_batch = 16,
+                 Release release = nullptr)
+        : sink_(std::move(sink)), release_(std::move(release)),
+          window_(window), max_batch_(max_batch) {}
+
+    ~WriteBatcher() {
+        stop();
+    }
+
+    // Restricts the flusher thread to the given CPUs once start() runs
+    // (see cpu_affinity.h); empty leaves placement to the kernel.
+    void set_cpuset(std::vector<int> cpus) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpuset_ = std::move(cpus);
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (flusher_.joinable()) {
+            return;
+        }
+        stopping_ = false;
+        flusher_ = std::thread([this] {
+            cpu_affinity::pin_current_thread(cpuset_);
+            flushLoop();
+        });
+    }
+
+    // Flushes whatever is queued, then joins the flusher.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (flusher_.joinable()) {
+            flusher_.join();
+        }
+    }
+
+    // Drops everything still queued, recycling the messages without
+    // writing them. Used between stream sessions: responses stranded by
+    // a dead stream must not leak onto the next one.
+    void discard_pending() {
+        std::deque<hub::Message*> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dropped.swap(queue_);
+        }
+        for (hub::Message* msg : dropped) {
+            if (release_) {
+                release_(msg);
+            }
+        }
+    }
+
+    // Takes ownership of msg until it is written (then Release fires).
+    void enqueue(hub::Message* msg) {
+        size_t depth;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(msg);
+            depth = queue_.size();
+        }
+        if (depth == 1 || depth >= max_batch_) {
+            cv_.notify_one();
+        }
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // stopping and drained
+            }
+            // Let a burst accumulate briefly unless the batch is already
+            // full or we are shutting down.
+            if (!stopping_ && queue_.size() < max_batch_) {
+                cv_.wait_for(lock, window_, [this] {
+                    return stopping_ || queue_.size() >= max_batch_;
+                });
+            }
+
+            std::deque<hub::Message*> batch;
+            batch.swap(queue_);
+            lock.unlock();
+            for (size_t i = 0; i < batch.size(); i++) {
+                sink_(*batch[i], i + 1 == batch.size());
+                if (release_) {
+                    release_(batch[i]);
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    Sink sink_;
+    Release release_;
+    std::chrono::microseconds window_;
+    size_t max_batch_;
+    std::vector<int> cpuset_;  // empty = kernel placement
+    bool stopping_ = false;
+    std::deque<hub::Message*> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread flusher_;
+};